@@ -23,16 +23,35 @@ SOFTWARE.
 -------------------------------------------------------------------------------*/
 
 #include "App.h"
+#include "base/AssetLoader.h"
+#include "base/AssetPack.h"
 #include "base/DataZipFile.h"
+#include "base/DiskCache.h"
+#include "base/FontCache.h"
 #include "base/Window.h"
 #include "base/Graphics.h"
 #include "base/SceneManager.h"
+#include "base/TextureCache.h"
+#include "base/TextureAtlas.h"
 #include "scene_game/SceneGame.h"
+#include "scene_game/GameBoard.h"
 
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
 #include <SDL2/SDL_ttf.h>
 
+// SDL_RenderGeometry, SDL_RenderSetVSync and SDL_GetTicks64 need SDL 2.0.18;
+// TTF_RenderGlyph32_Blended and TTF_GetFontKerningSizeGlyphs32 need SDL_ttf 2.0.18.
+#if !SDL_VERSION_ATLEAST(2, 0, 18)
+    #error "SDL 2.0.18 or newer is required"
+#endif
+
+#if !defined(SDL_TTF_VERSION_ATLEAST)
+    #error "SDL_ttf 2.0.18 or newer is required"
+#elif !SDL_TTF_VERSION_ATLEAST(2, 0, 18)
+    #error "SDL_ttf 2.0.18 or newer is required"
+#endif
+
 #include <stdbool.h>
 #include <stdio.h>
 #include <time.h>
@@ -48,7 +67,15 @@ struct App
     SceneManager *sceneManager;
 };
 
+static const char * const WindowIcon = "images/brain_1f9e0.png";
+static const char * const AssetPackFile = "assets.pack";
+static const char * const DefaultFont = "fonts/NotoSans-Bold.ttf";
+static const double SimulationStep = 1.0 / 120.0;
+
 static void InitSDL();
+static void LoadTextureAtlas(App * const self);
+static void SetFramePacing(App * const self, const char *pacing);
+static void OnWindowIconLoaded(void *userdata, const char *fileName, SDL_Surface *surface);
 
 App *App_New()
 {
@@ -59,6 +86,14 @@ App *App_New()
         return NULL;
 #endif
 
+    // Optional: falls back to decoding the original files when missing.
+    AssetPack_Init(AssetPackFile);
+
+#if defined(USE_DISK_CACHE) && !defined(__EMSCRIPTEN__)
+    // MEMORY_GAME_CACHE_DIR overrides the default XDG cache location.
+    DiskCache_Init(SDL_getenv("MEMORY_GAME_CACHE_DIR"));
+#endif
+
     InitSDL();
 
     App * const self = malloc(sizeof (App));
@@ -67,9 +102,23 @@ App *App_New()
     self->graphics = Graphics_New(self->window);
     self->sceneManager = SceneManager_New(self->window, self->graphics);
 
+    // MEMORY_GAME_TEXTURE_BUDGET_MB caps the estimated VRAM used by image textures.
+    const char *budget = SDL_getenv("MEMORY_GAME_TEXTURE_BUDGET_MB");
+
+    if (budget)
+        TextureCache_SetBudget(Graphics_GetTextureCache(self->graphics), (size_t)SDL_atoi(budget) * 1024 * 1024);
+
+    // MEMORY_GAME_FRAME_PACING is vsync (default), uncapped, adaptive or a target FPS.
+    SetFramePacing(self, SDL_getenv("MEMORY_GAME_FRAME_PACING"));
+
+    // Animations advance in fixed steps and are interpolated when drawn.
+    SceneManager_SetFixedTimestep(self->sceneManager, SimulationStep);
+
+    LoadTextureAtlas(self);
+
     SCENE_MANAGER_GOTO(self->sceneManager, SceneGame);
 
-    Window_SetWindowIcon(self->window, "images/brain_1f9e0.png");
+    AssetLoader_LoadImage(Graphics_GetAssetLoader(self->graphics), WindowIcon, OnWindowIconLoaded, self->window);
     Window_Show(self->window);
 
     return self;
@@ -87,6 +136,10 @@ void App_Delete(App * const self)
 
     free(self);
 
+    FontCache_Clear();
+    AssetPack_Close();
+    DiskCache_Close();
+
     IMG_Quit();
     TTF_Quit();
     SDL_Quit();
@@ -104,7 +157,7 @@ void App_Run(App * const self)
 
 void InitSDL()
 {
-    if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_TIMER) < 0)
+    if (SDL_Init(SDL_INIT_VIDEO) < 0)
     {
         printf("SDL could not initialize! SDL Error: %s\n", SDL_GetError());
         exit(-1);
@@ -129,3 +182,42 @@ void InitSDL()
         exit(-1);
     }
 }
+
+void SetFramePacing(App * const self, const char *pacing)
+{
+    if (!pacing || SDL_strcasecmp(pacing, "vsync") == 0)
+        return;
+
+    if (SDL_strcasecmp(pacing, "uncapped") == 0)
+        SceneManager_SetFramePacing(self->sceneManager, FramePacing_Uncapped, 0);
+
+    else if (SDL_strcasecmp(pacing, "adaptive") == 0)
+        SceneManager_SetFramePacing(self->sceneManager, FramePacing_Adaptive, 0);
+
+    else if (SDL_atoi(pacing) > 0)
+        SceneManager_SetFramePacing(self->sceneManager, FramePacing_Fixed, SDL_atoi(pacing));
+
+    else
+        printf("Unknown frame pacing \"%s\", keeping vsync\n", pacing);
+}
+
+void LoadTextureAtlas(App * const self)
+{
+    TextureCache *cache = Graphics_GetTextureCache(self->graphics);
+    TextureAtlas *atlas = TextureAtlas_New(Graphics_GetRenderer(self->graphics),
+                                           Graphics_GetRenderBatch(self->graphics), 512, 512);
+
+    // The images are decoded in the background; the atlas is uploaded once they are all in.
+    GameBoard_AddImagesToAtlas(cache, atlas);
+    TextureCache_AddAtlas(cache, atlas);
+
+    AssetLoader_LoadFont(Graphics_GetAssetLoader(self->graphics), DefaultFont);
+}
+
+void OnWindowIconLoaded(void *userdata, const char *fileName, SDL_Surface *surface)
+{
+    (void)fileName;
+
+    if (surface)
+        SDL_SetWindowIcon(Window_GetSDLWindow(userdata), surface);
+}
@@ -0,0 +1,321 @@
+//-------------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Fábio Pichler
+/*-------------------------------------------------------------------------------
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+-------------------------------------------------------------------------------*/
+
+#include "AssetLoader.h"
+#include "FontCache.h"
+#include "ImageLoader.h"
+#include "LinkedList.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define MAX_WORKERS 8
+
+typedef enum JobType
+{
+    Job_Image,
+    Job_Font,
+} JobType;
+
+typedef struct Job
+{
+    JobType type;
+    char *fileName;
+    AssetLoader_ImageCallback callback;
+    void *userdata;
+    SDL_Surface *surface;
+} Job;
+
+struct AssetLoader
+{
+    SDL_Thread *threads[MAX_WORKERS];
+    int threadCount;
+    SDL_mutex *mutex;
+    SDL_cond *cond;
+    bool quit;
+
+    LinkedList *pending;
+    LinkedList *finished;
+    int running;
+
+    Uint64 batchStart;
+    int batchImages;
+    double imagesPerSecond;
+};
+
+void AssetLoader_Push(AssetLoader * const self, JobType type, const char *fileName,
+                      AssetLoader_ImageCallback callback, void *userdata);
+void AssetLoader_Run(Job *job);
+void AssetLoader_JobDone(AssetLoader * const self, Job *job);
+
+static int WorkerThread(void *data);
+static Job *PopJob(LinkedList *list);
+static void DeleteJob(Job *job);
+
+AssetLoader *AssetLoader_New()
+{
+    AssetLoader * const self = malloc(sizeof (AssetLoader));
+
+    self->mutex = SDL_CreateMutex();
+    self->cond = SDL_CreateCond();
+    self->quit = false;
+    self->pending = LinkedList_New();
+    self->finished = LinkedList_New();
+    self->running = 0;
+    self->threadCount = 0;
+    self->batchStart = 0;
+    self->batchImages = 0;
+    self->imagesPerSecond = 0.0;
+
+    // One core is left to the main thread, which does the uploads.
+    const int workers = SDL_max(1, SDL_min(SDL_GetCPUCount() - 1, MAX_WORKERS));
+
+    for (int i = 0; i < workers && self->mutex && self->cond; ++i)
+    {
+        SDL_Thread *thread = SDL_CreateThread(WorkerThread, "AssetLoader", self);
+
+        if (!thread)
+            break;
+
+        self->threads[self->threadCount++] = thread;
+    }
+
+    if (self->threadCount == 0)
+        printf("Asset loader threads unavailable, loading on the main thread. SDL Error: %s\n", SDL_GetError());
+
+    return self;
+}
+
+void AssetLoader_Delete(AssetLoader * const self)
+{
+    if (!self)
+        return;
+
+    SDL_LockMutex(self->mutex);
+    self->quit = true;
+    SDL_CondBroadcast(self->cond);
+    SDL_UnlockMutex(self->mutex);
+
+    for (int i = 0; i < self->threadCount; ++i)
+        SDL_WaitThread(self->threads[i], NULL);
+
+    for (Job *job; (job = PopJob(self->pending)) != NULL;)
+        DeleteJob(job);
+
+    for (Job *job; (job = PopJob(self->finished)) != NULL;)
+        DeleteJob(job);
+
+    LinkedList_Delete(self->pending);
+    LinkedList_Delete(self->finished);
+    SDL_DestroyCond(self->cond);
+    SDL_DestroyMutex(self->mutex);
+
+    free(self);
+}
+
+void AssetLoader_LoadImage(AssetLoader * const self, const char *fileName, AssetLoader_ImageCallback callback,
+                           void *userdata)
+{
+    AssetLoader_Push(self, Job_Image, fileName, callback, userdata);
+}
+
+void AssetLoader_LoadFont(AssetLoader * const self, const char *fileName)
+{
+    AssetLoader_Push(self, Job_Font, fileName, NULL, NULL);
+}
+
+void AssetLoader_Update(AssetLoader * const self, Uint32 budgetMs)
+{
+    const Uint32 start = SDL_GetTicks();
+
+    // Always hand over at least one result so loading keeps progressing on slow frames.
+    do
+    {
+        SDL_LockMutex(self->mutex);
+
+        Job *job = PopJob(self->finished);
+        const bool decode = !job && self->threadCount == 0;
+
+        if (decode)
+            job = PopJob(self->pending);
+
+        SDL_UnlockMutex(self->mutex);
+
+        if (!job)
+            return;
+
+        if (decode)
+        {
+            AssetLoader_Run(job);
+
+            SDL_LockMutex(self->mutex);
+            AssetLoader_JobDone(self, job);
+            SDL_UnlockMutex(self->mutex);
+        }
+
+        if (job->callback)
+            job->callback(job->userdata, job->fileName, job->surface);
+
+        DeleteJob(job);
+    }
+    while (SDL_GetTicks() - start < budgetMs);
+}
+
+double AssetLoader_GetImagesPerSecond(AssetLoader * const self)
+{
+    SDL_LockMutex(self->mutex);
+    const double imagesPerSecond = self->imagesPerSecond;
+    SDL_UnlockMutex(self->mutex);
+
+    return imagesPerSecond;
+}
+
+bool AssetLoader_IsBusy(AssetLoader * const self)
+{
+    SDL_LockMutex(self->mutex);
+
+    const bool busy = self->running > 0
+            || LinkedList_GetSize(self->pending) > 0
+            || LinkedList_GetSize(self->finished) > 0;
+
+    SDL_UnlockMutex(self->mutex);
+
+    return busy;
+}
+
+void AssetLoader_Push(AssetLoader * const self, JobType type, const char *fileName,
+                      AssetLoader_ImageCallback callback, void *userdata)
+{
+    Job *job = malloc(sizeof (Job));
+    const size_t size = strlen(fileName) + 1;
+
+    job->type = type;
+    job->fileName = malloc(size);
+    job->callback = callback;
+    job->userdata = userdata;
+    job->surface = NULL;
+
+    memcpy(job->fileName, fileName, size);
+
+    SDL_LockMutex(self->mutex);
+
+    if (LinkedList_GetSize(self->pending) == 0 && self->running == 0 && self->batchImages == 0)
+        self->batchStart = SDL_GetPerformanceCounter();
+
+    LinkedList_PushPtr(self->pending, job);
+    SDL_CondSignal(self->cond);
+    SDL_UnlockMutex(self->mutex);
+}
+
+void AssetLoader_Run(Job *job)
+{
+    if (job->type == Job_Font)
+    {
+        FontCache_Preload(job->fileName);
+        return;
+    }
+
+    if (!(job->surface = ImageLoader_Load(job->fileName)))
+        printf("Unable to load image %s! SDL_image Error: %s\n", job->fileName, SDL_GetError());
+}
+
+void AssetLoader_JobDone(AssetLoader * const self, Job *job)
+{
+    if (job->type == Job_Image)
+        self->batchImages++;
+
+    if (LinkedList_GetSize(self->pending) > 0 || self->running > 0 || self->batchImages == 0)
+        return;
+
+    // The queue just drained: report how fast this batch was decoded.
+    const double seconds = (double)(SDL_GetPerformanceCounter() - self->batchStart)
+            / (double)SDL_GetPerformanceFrequency();
+
+    self->imagesPerSecond = seconds > 0.0 ? self->batchImages / seconds : 0.0;
+
+#ifdef RENDER_STATS
+    printf("Decoded %d images in %.1f ms on %d thread(s), %.0f images/sec\n",
+           self->batchImages, seconds * 1000.0, SDL_max(self->threadCount, 1), self->imagesPerSecond);
+#endif
+
+    self->batchImages = 0;
+}
+
+int WorkerThread(void *data)
+{
+    AssetLoader * const self = data;
+
+    SDL_LockMutex(self->mutex);
+
+    while (!self->quit)
+    {
+        Job *job = PopJob(self->pending);
+
+        if (!job)
+        {
+            SDL_CondWait(self->cond, self->mutex);
+            continue;
+        }
+
+        self->running++;
+        SDL_UnlockMutex(self->mutex);
+
+        AssetLoader_Run(job);
+
+        SDL_LockMutex(self->mutex);
+        self->running--;
+
+        AssetLoader_JobDone(self, job);
+
+        if (job->type == Job_Image)
+            LinkedList_PushPtr(self->finished, job);
+        else
+            DeleteJob(job);
+    }
+
+    SDL_UnlockMutex(self->mutex);
+
+    return 0;
+}
+
+Job *PopJob(LinkedList *list)
+{
+    LinkedListNode *node = LinkedList_GetFirst(list);
+
+    if (!node)
+        return NULL;
+
+    Job *job = LinkedList_GetValuePtr(list, node);
+    LinkedList_Remove(list, &node);
+
+    return job;
+}
+
+void DeleteJob(Job *job)
+{
+    SDL_FreeSurface(job->surface);
+
+    free(job->fileName);
+    free(job);
+}
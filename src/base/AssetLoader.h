@@ -0,0 +1,57 @@
+//-------------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Fábio Pichler
+/*-------------------------------------------------------------------------------
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+-------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Decodes images and reads fonts on a pool of worker threads sized to
+// the CPU count. Decoded surfaces are handed back on the thread calling
+// AssetLoader_Update, where they can be uploaded to the renderer.
+// Without thread support the jobs are decoded inside AssetLoader_Update.
+
+typedef struct AssetLoader AssetLoader;
+
+// The surface is NULL when decoding failed; it is freed after the callback returns.
+typedef void (*AssetLoader_ImageCallback)(void *userdata, const char *fileName, SDL_Surface *surface);
+
+AssetLoader *AssetLoader_New();
+void AssetLoader_Delete(AssetLoader * const self);
+
+void AssetLoader_LoadImage(AssetLoader * const self, const char *fileName, AssetLoader_ImageCallback callback,
+                           void *userdata);
+void AssetLoader_LoadFont(AssetLoader * const self, const char *fileName);
+
+void AssetLoader_Update(AssetLoader * const self, Uint32 budgetMs);
+double AssetLoader_GetImagesPerSecond(AssetLoader * const self);
+bool AssetLoader_IsBusy(AssetLoader * const self);
+
+#ifdef __cplusplus
+}
+#endif
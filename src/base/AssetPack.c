@@ -0,0 +1,198 @@
+//-------------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Fábio Pichler
+/*-------------------------------------------------------------------------------
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+-------------------------------------------------------------------------------*/
+
+#include "AssetPack.h"
+#include "private/AssetPackFormat.h"
+#include "private/MappedFile.h"
+
+#include <stdio.h>
+#include <string.h>
+
+typedef struct PackEntry
+{
+    Uint32 type;
+    int width;
+    int height;
+    int pitch;
+    const unsigned char *data;
+    size_t size;
+} PackEntry;
+
+static MappedFile *pack = NULL;
+static Uint32 pixelFormat = SDL_PIXELFORMAT_UNKNOWN;
+
+static Uint32 ReadU32(const unsigned char *p)
+{
+    return (Uint32)p[0] | ((Uint32)p[1] << 8) | ((Uint32)p[2] << 16) | ((Uint32)p[3] << 24);
+}
+
+static bool FindEntry(const char *name, PackEntry *entry);
+static bool ValidRecord(const unsigned char *record, size_t size, size_t names);
+
+bool AssetPack_Init(const char *fileName)
+{
+    AssetPack_Close();
+
+    if (!(pack = MappedFile_Open(fileName)))
+        return false;
+
+    const unsigned char *data = MappedFile_Data(pack);
+    const size_t size = MappedFile_Size(pack);
+
+    if (size < ASSET_PACK_HEADER_SIZE
+            || memcmp(data, ASSET_PACK_MAGIC, 4) != 0
+            || ReadU32(data + 4) != ASSET_PACK_VERSION)
+    {
+        printf("%s is not a compatible asset pack.\n", fileName);
+        AssetPack_Close();
+
+        return false;
+    }
+
+    const Uint32 count = ReadU32(data + 12);
+    const Uint32 slots = ReadU32(data + 16);
+    const size_t names = ReadU32(data + 28);
+    bool valid = (Uint64)ReadU32(data + 20) + (Uint64)count * ASSET_PACK_ENTRY_SIZE <= size
+            && (Uint64)ReadU32(data + 24) + (Uint64)slots * 4 <= size
+            && (slots & (slots - 1)) == 0
+            && names <= size;
+
+    // A truncated or damaged pack is rejected as a whole, so assets come from data.zip instead.
+    for (Uint32 i = 0; valid && i < count; ++i)
+        valid = ValidRecord(data + ReadU32(data + 20) + (size_t)i * ASSET_PACK_ENTRY_SIZE, size, names);
+
+    if (!valid)
+    {
+        printf("%s is corrupted.\n", fileName);
+        AssetPack_Close();
+
+        return false;
+    }
+
+    pixelFormat = ReadU32(data + 8);
+
+    return true;
+}
+
+void AssetPack_Close()
+{
+    MappedFile_Close(pack);
+
+    pack = NULL;
+    pixelFormat = SDL_PIXELFORMAT_UNKNOWN;
+}
+
+SDL_Surface *AssetPack_LoadSurface(const char *name)
+{
+    PackEntry entry;
+
+    if (!FindEntry(name, &entry) || entry.type != AssetPack_Image)
+        return NULL;
+
+    // The surface only borrows the pixels; the pack stays mapped until AssetPack_Close.
+    return SDL_CreateRGBSurfaceWithFormatFrom((void *)entry.data, entry.width, entry.height, 32, entry.pitch,
+                                              pixelFormat);
+}
+
+bool AssetPack_Map(const char *name, const void **data, size_t *size)
+{
+    PackEntry entry;
+
+    if (!FindEntry(name, &entry) || entry.type != AssetPack_Raw)
+        return false;
+
+    *data = entry.data;
+    *size = entry.size;
+
+    return true;
+}
+
+bool FindEntry(const char *name, PackEntry *entry)
+{
+    if (!pack)
+        return false;
+
+    const unsigned char *data = MappedFile_Data(pack);
+    const size_t size = MappedFile_Size(pack);
+    const Uint32 count = ReadU32(data + 12);
+    const Uint32 slots = ReadU32(data + 16);
+    const unsigned char *entries = data + ReadU32(data + 20);
+    const unsigned char *table = data + ReadU32(data + 24);
+    const unsigned char *names = data + ReadU32(data + 28);
+    const size_t length = strlen(name);
+
+    if (slots == 0)
+        return false;
+
+    for (Uint32 i = 0, slot = AssetPack_Hash(name, length) & (slots - 1); i < slots; ++i, slot = (slot + 1) & (slots - 1))
+    {
+        const Uint32 index = ReadU32(table + slot * 4);
+
+        if (index == 0 || index > count)
+            return false;
+
+        const unsigned char *record = entries + (index - 1) * ASSET_PACK_ENTRY_SIZE;
+
+        if (!ValidRecord(record, size, names - data))
+            return false;
+
+        if (ReadU32(record + 4) != length || memcmp(names + ReadU32(record), name, length) != 0)
+            continue;
+
+        const size_t offset = ReadU32(record + 24);
+
+        *entry = (PackEntry) {
+            .type = ReadU32(record + 8),
+            .width = (int)ReadU32(record + 12),
+            .height = (int)ReadU32(record + 16),
+            .pitch = (int)ReadU32(record + 20),
+            .data = data + offset,
+            .size = ReadU32(record + 28),
+        };
+
+        return true;
+    }
+
+    return false;
+}
+
+bool ValidRecord(const unsigned char *record, size_t size, size_t names)
+{
+    const Uint64 nameEnd = (Uint64)ReadU32(record) + ReadU32(record + 4);
+    const Uint64 dataSize = ReadU32(record + 28);
+
+    if (nameEnd > size - names || (Uint64)ReadU32(record + 24) + dataSize > size)
+        return false;
+
+    if (ReadU32(record + 8) != AssetPack_Image)
+        return true;
+
+    const Uint64 width = ReadU32(record + 12);
+    const Uint64 height = ReadU32(record + 16);
+    const Uint64 pitch = ReadU32(record + 20);
+
+    // The surface handed to SDL must not reach past the entry's bytes.
+    return width <= SDL_MAX_SINT32 && height <= SDL_MAX_SINT32 && pitch <= SDL_MAX_SINT32
+            && pitch >= width * 4 && pitch * height <= dataSize;
+}
@@ -23,6 +23,7 @@ SOFTWARE.
 -------------------------------------------------------------------------------*/
 
 #include "Box.h"
+#include "Damage.h"
 
 typedef struct Box_UpdatedEvent
 {
@@ -36,6 +37,7 @@ struct Box
     Box_UpdatedEvent updatedEvent;
 };
 
+void Box_SetRect(Box * const self, float x, float y, float w, float h);
 void Box_CallUpdatedEvent(Box * const self);
 
 Box *Box_New(float x, float y, float width, float height)
@@ -67,6 +69,16 @@ void *Box_GetEventUserData(Box * const self)
     return self->updatedEvent.userdata;
 }
 
+void Box_SetRect(Box * const self, float x, float y, float w, float h)
+{
+    if (x != self->rect.x || y != self->rect.y || w != self->rect.w || h != self->rect.h)
+        Damage_Invalidate();
+
+    self->rect = (SDL_FRect) {x, y, w, h};
+
+    Box_CallUpdatedEvent(self);
+}
+
 void Box_CallUpdatedEvent(Box * const self)
 {
     if (self->updatedEvent.function)
@@ -75,54 +87,37 @@ void Box_CallUpdatedEvent(Box * const self)
 
 void Box_SetSize(Box * const self, float w, float h)
 {
-    self->rect.w = w;
-    self->rect.h = h;
-
-    Box_CallUpdatedEvent(self);
+    Box_SetRect(self, self->rect.x, self->rect.y, w, h);
 }
 
 void Box_SetPosition(Box * const self, float x, float y)
 {
-    self->rect.x = x;
-    self->rect.y = y;
-
-    Box_CallUpdatedEvent(self);
+    Box_SetRect(self, x, y, self->rect.w, self->rect.h);
 }
 
 void Box_SetX(Box * const self, float x)
 {
-    self->rect.x = x;
-
-    Box_CallUpdatedEvent(self);
+    Box_SetRect(self, x, self->rect.y, self->rect.w, self->rect.h);
 }
 
 void Box_SetY(Box * const self, float y)
 {
-    self->rect.y = y;
-
-    Box_CallUpdatedEvent(self);
+    Box_SetRect(self, self->rect.x, y, self->rect.w, self->rect.h);
 }
 
 void Box_SetWidth(Box * const self, float w)
 {
-    self->rect.w = w;
-
-    Box_CallUpdatedEvent(self);
+    Box_SetRect(self, self->rect.x, self->rect.y, w, self->rect.h);
 }
 
 void Box_SetHeight(Box * const self, float h)
 {
-    self->rect.h = h;
-
-    Box_CallUpdatedEvent(self);
+    Box_SetRect(self, self->rect.x, self->rect.y, self->rect.w, h);
 }
 
 void Box_Move(Box * const self, float velX, float velY)
 {
-    self->rect.x += velX;
-    self->rect.y += velY;
-
-    Box_CallUpdatedEvent(self);
+    Box_SetRect(self, self->rect.x + velX, self->rect.y + velY, self->rect.w, self->rect.h);
 }
 
 float Box_X(Box * const self)
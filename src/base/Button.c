@@ -25,6 +25,10 @@ SOFTWARE.
 #include "Button.h"
 #include "Rectangle.h"
 #include "Box.h"
+#include "Damage.h"
+#include "DisplayList.h"
+#include "Graphics.h"
+#include "RenderBatch.h"
 
 #include <malloc.h>
 
@@ -43,7 +47,7 @@ typedef struct Button_PressedEvent
 
 struct Button
 {
-    SDL_Renderer *renderer;
+    Graphics *graphics;
 
     Texture *textTexture;
     Texture *iconTexture;
@@ -66,13 +70,15 @@ struct Button
 bool Button_PointerIsHovering(Button * const self, const SDL_Event *event);
 void Button_OnUpdateBox(Button * const self);
 void Button_CallPressedEvent(Button * const self);
+void Button_SetState(Button * const self, State state);
+void Button_UpdateBackground(Button * const self);
 void Button_BoxOnUpdateEvent(Box * const box, void *userdata);
 
-Button *Button_New(SDL_Renderer *renderer)
+Button *Button_New(Graphics *graphics)
 {
     Button * const self = malloc(sizeof (Button));
 
-    self->renderer = renderer;
+    self->graphics = graphics;
     self->textTexture = NULL;
     self->iconTexture = NULL;
 
@@ -86,9 +92,10 @@ Button *Button_New(SDL_Renderer *renderer)
 
     self->box = Box_New(0.f, 0.f, 60.f, 40.f);
 
-    self->background = Rectangle_New(self->renderer, Box_Width(self->box), Box_Height(self->box));
+    self->background = Rectangle_New(self->graphics, Box_Width(self->box), Box_Height(self->box));
 
     Box_SetOnPressEvent(self->box, Button_BoxOnUpdateEvent, self);
+    Button_UpdateBackground(self);
 
     return self;
 }
@@ -108,6 +115,8 @@ void Button_SetBackgroundColorRGB(Button * const self, uint8_t r, uint8_t g, uin
     self->color.g = g;
     self->color.b = b;
     self->color.a = 255;
+
+    Button_UpdateBackground(self);
 }
 
 void Button_SetBackgroundColorRGBA(Button * const self, uint8_t r, uint8_t g, uint8_t b, uint8_t a)
@@ -116,6 +125,8 @@ void Button_SetBackgroundColorRGBA(Button * const self, uint8_t r, uint8_t g, ui
     self->color.g = g;
     self->color.b = b;
     self->color.a = a;
+
+    Button_UpdateBackground(self);
 }
 
 void Button_SetBackgroundHoverColorRGB(Button * const self, uint8_t r, uint8_t g, uint8_t b)
@@ -124,6 +135,8 @@ void Button_SetBackgroundHoverColorRGB(Button * const self, uint8_t r, uint8_t g
     self->colorHover.g = g;
     self->colorHover.b = b;
     self->colorHover.a = 255;
+
+    Button_UpdateBackground(self);
 }
 
 void Button_SetBackgroundHoverColorRGBA(Button * const self, uint8_t r, uint8_t g, uint8_t b, uint8_t a)
@@ -132,6 +145,8 @@ void Button_SetBackgroundHoverColorRGBA(Button * const self, uint8_t r, uint8_t
     self->colorHover.g = g;
     self->colorHover.b = b;
     self->colorHover.a = a;
+
+    Button_UpdateBackground(self);
 }
 
 void Button_SetBackgroundPressedColorRGB(Button * const self, uint8_t r, uint8_t g, uint8_t b)
@@ -140,6 +155,8 @@ void Button_SetBackgroundPressedColorRGB(Button * const self, uint8_t r, uint8_t
     self->colorPressed.g = g;
     self->colorPressed.b = b;
     self->colorPressed.a = 255;
+
+    Button_UpdateBackground(self);
 }
 
 void Button_SetBackgroundPressedColorRGBA(Button * const self, uint8_t r, uint8_t g, uint8_t b, uint8_t a)
@@ -148,6 +165,8 @@ void Button_SetBackgroundPressedColorRGBA(Button * const self, uint8_t r, uint8_
     self->colorPressed.g = g;
     self->colorPressed.b = b;
     self->colorPressed.a = a;
+
+    Button_UpdateBackground(self);
 }
 
 void Button_SetTextColorRGB(Button * const self, uint8_t r, uint8_t g, uint8_t b)
@@ -169,7 +188,7 @@ void Button_SetTextColorRGBA(Button * const self, uint8_t r, uint8_t g, uint8_t
 bool Button_SetText(Button * const self, const char *text, int ptsize)
 {
     if (!self->textTexture)
-        self->textTexture = Texture_New(self->renderer);
+        self->textTexture = Texture_New(self->graphics);
 
     Texture_SetTextColor(self->textTexture, &self->textColor);
     Texture_SetTextSize(self->textTexture, ptsize);
@@ -188,6 +207,8 @@ void Button_SetIcon(Button * const self, Texture *texture)
 {
     self->iconTexture = texture;
     Button_OnUpdateBox(self);
+
+    Damage_Invalidate();
 }
 
 void Button_SetOnPressEvent(Button * const self, Button_OnPressEvent callback, void *userdata)
@@ -215,7 +236,7 @@ void Button_ProcessEvent(Button * const self, const SDL_Event *event)
         {
             if (event->type == SDL_MOUSEBUTTONDOWN)
             {
-                self->state = Pressed;
+                Button_SetState(self, Pressed);
 
                 Button_CallPressedEvent(self);
 
@@ -228,30 +249,58 @@ void Button_ProcessEvent(Button * const self, const SDL_Event *event)
         }
 
         if (Button_PointerIsHovering(self, event))
-            self->state = Hover;
+            Button_SetState(self, Hover);
         else
-            self->state = Normal;
+            Button_SetState(self, Normal);
     }
 }
 
-void Button_Draw(Button * const self)
+void Button_SetState(Button * const self, State state)
 {
-    Button_OnUpdateBox(self);
+    self->state = state;
+    Button_UpdateBackground(self);
+}
 
+void Button_UpdateBackground(Button * const self)
+{
+    // Rectangle_SetColor marks damage when the color actually changes.
     if (self->state == Hover)
         Rectangle_SetColor(self->background, self->colorHover);
     else if (self->state == Pressed)
         Rectangle_SetColor(self->background, self->colorPressed);
     else
         Rectangle_SetColor(self->background, self->color);
+}
+
+void Button_Draw(Button * const self)
+{
+    RenderBatch *batch = Graphics_GetRenderBatch(self->graphics);
+    const int layer = RenderBatch_GetLayer(batch);
 
     Rectangle_Draw(self->background);
 
+    // Same contract as Button_AddToDisplayList: content one layer above the background.
+    RenderBatch_SetLayer(batch, layer + 1);
+
     if (self->iconTexture)
         Texture_Draw(self->iconTexture);
 
     if (self->textTexture)
         Texture_Draw(self->textTexture);
+
+    RenderBatch_SetLayer(batch, layer);
+}
+
+void Button_AddToDisplayList(Button * const self, DisplayList *displayList)
+{
+    const int layer = DisplayList_GetLayer(displayList);
+
+    // Content goes one layer up, so every button background is drawn before any icon.
+    Rectangle_AddToDisplayList(self->background, displayList);
+    DisplayList_SetLayer(displayList, layer + 1);
+    DisplayList_AddTexture(displayList, &self->iconTexture);
+    DisplayList_AddTexture(displayList, &self->textTexture);
+    DisplayList_SetLayer(displayList, layer);
 }
 
 bool Button_PointerIsHovering(Button * const self, const SDL_Event *event)
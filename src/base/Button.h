@@ -35,12 +35,14 @@ extern "C" {
 #endif
 
 typedef struct Texture Texture;
+typedef struct DisplayList DisplayList;
+typedef struct Graphics Graphics;
 
 typedef struct Button Button;
 
 typedef void (*Button_OnPressEvent)(Button * const button, void *user);
 
-Button *Button_New(SDL_Renderer *renderer);
+Button *Button_New(Graphics *graphics);
 void Button_Delete(Button * const self);
 void Button_SetBackgroundColorRGB(Button * const self, uint8_t r, uint8_t g, uint8_t b);
 void Button_SetBackgroundColorRGBA(Button * const self, uint8_t r, uint8_t g, uint8_t b, uint8_t a);
@@ -56,6 +58,7 @@ void Button_SetOnPressEvent(Button * const self, Button_OnPressEvent callback, v
 void *Button_GetEventUserData(Button * const self);
 void Button_ProcessEvent(Button * const self, const SDL_Event *event);
 void Button_Draw(Button * const self);
+void Button_AddToDisplayList(Button * const self, DisplayList *displayList);
 
 Box *Button_Box(Button * const self);
 Texture *Button_Icon(Button * const self);
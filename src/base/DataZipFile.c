@@ -26,11 +26,54 @@ SOFTWARE.
 
 #ifdef USE_DATA_ZIP
 
+#include "LinkedList.h"
+#include "private/MappedFile.h"
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <physfs.h>
 
+#define MAX_POOLED_BUFFERS 8
+#define MAX_BUFFERED_SIZE (1024 * 1024)
+
+typedef struct ZipEntry
+{
+    const char *name;
+    size_t nameLength;
+    size_t offset;
+    size_t size;
+    bool stored;
+} ZipEntry;
+
+typedef struct PooledBuffer
+{
+    char *data;
+    size_t capacity;
+} PooledBuffer;
+
+typedef struct PooledReader
+{
+    PooledBuffer *buffer;
+    size_t size;
+    size_t position;
+} PooledReader;
+
+static MappedFile *archive = NULL;
+static ZipEntry *entries = NULL;
+static int entryCount = 0;
+static LinkedList *bufferPool = NULL;
+static SDL_SpinLock bufferPoolLock = 0;
+
+static bool DataZipFile_MapArchive(const char *fileName);
+static void DataZipFile_UnmapArchive();
+static const ZipEntry *DataZipFile_FindEntry(const char *filename);
+static PooledBuffer *DataZipFile_AcquireBuffer(size_t size);
+static void DataZipFile_ReleaseBuffer(PooledBuffer *buffer);
+static SDL_RWops *DataZipFile_PooledRW(PooledBuffer *buffer, size_t size);
+static SDL_RWops *DataZipFile_PhysFSRW(PHYSFS_File *file);
+
 bool DataZipFile_Init()
 {
     if (!PHYSFS_init(NULL))
@@ -48,11 +91,32 @@ bool DataZipFile_Init()
         return false;
     }
 
+    bufferPool = LinkedList_New();
+
+    // Without a mapping every entry is still served through PhysicsFS.
+    if (!DataZipFile_MapArchive("data.zip"))
+        printf("data.zip could not be memory-mapped, reading through PhysicsFS.\n");
+
     return true;
 }
 
 void DataZipFile_Close()
 {
+    DataZipFile_UnmapArchive();
+
+    for (LinkedListNode *iterator = LinkedList_GetFirst(bufferPool); iterator != NULL;)
+    {
+        PooledBuffer *buffer = LinkedList_GetValuePtr(bufferPool, iterator);
+
+        free(buffer->data);
+        free(buffer);
+
+        LinkedList_Next(bufferPool, &iterator);
+    }
+
+    LinkedList_Delete(bufferPool);
+    bufferPool = NULL;
+
     PHYSFS_deinit();
 }
 
@@ -88,15 +152,429 @@ int DataZipFile_Read(const char *filename, char **buffer)
     return 0;
 }
 
+bool DataZipFile_Exists(const char *filename)
+{
+    return DataZipFile_FindEntry(filename) != NULL || PHYSFS_exists(filename);
+}
+
+bool DataZipFile_Map(const char *filename, const void **data, size_t *size)
+{
+    const ZipEntry *entry = DataZipFile_FindEntry(filename);
+
+    if (!entry || !entry->stored)
+        return false;
+
+    *data = MappedFile_Data(archive) + entry->offset;
+    *size = entry->size;
+
+    return true;
+}
+
 SDL_RWops *DataZipFile_Load_RW(const char *filename)
 {
-    char *buffer;
-    int size = DataZipFile_Read(filename, &buffer);
+    const void *data;
+    size_t size;
+
+    if (DataZipFile_Map(filename, &data, &size))
+        return SDL_RWFromConstMem(data, (int)size);
+
+    PHYSFS_File *file = PHYSFS_openRead(filename);
+
+    if (!file)
+    {
+        printf("failed to open. Reason: [%s].\n", PHYSFS_getLastError());
+        return NULL;
+    }
+
+    const PHYSFS_sint64 length = PHYSFS_fileLength(file);
+
+    if (length <= 0)
+    {
+        PHYSFS_close(file);
+        return NULL;
+    }
+
+    // Large compressed entries are streamed instead of buffered in full.
+    if (length > MAX_BUFFERED_SIZE)
+        return DataZipFile_PhysFSRW(file);
+
+    PooledBuffer *buffer = DataZipFile_AcquireBuffer((size_t)length);
+    const PHYSFS_sint64 readed = PHYSFS_readBytes(file, buffer->data, length);
+
+    PHYSFS_close(file);
+
+    if (readed != length)
+    {
+        printf("failed to read. Reason: [%s].\n", PHYSFS_getLastError());
+        DataZipFile_ReleaseBuffer(buffer);
+        return NULL;
+    }
+
+    return DataZipFile_PooledRW(buffer, (size_t)length);
+}
+
+SDL_RWops *DataZipFile_Stream_RW(const char *filename)
+{
+    PHYSFS_File *file = PHYSFS_openRead(filename);
+
+    if (!file)
+    {
+        printf("failed to open. Reason: [%s].\n", PHYSFS_getLastError());
+        return NULL;
+    }
+
+    return DataZipFile_PhysFSRW(file);
+}
+
+static Uint16 ReadU16(const unsigned char *p)
+{
+    return (Uint16)(p[0] | (p[1] << 8));
+}
+
+static Uint32 ReadU32(const unsigned char *p)
+{
+    return (Uint32)p[0] | ((Uint32)p[1] << 8) | ((Uint32)p[2] << 16) | ((Uint32)p[3] << 24);
+}
+
+static int CompareEntries(const void *a, const void *b)
+{
+    const ZipEntry *lhs = a;
+    const ZipEntry *rhs = b;
+    const size_t length = SDL_min(lhs->nameLength, rhs->nameLength);
+    const int result = memcmp(lhs->name, rhs->name, length);
+
+    if (result != 0)
+        return result;
+
+    return (lhs->nameLength > rhs->nameLength) - (lhs->nameLength < rhs->nameLength);
+}
+
+bool DataZipFile_MapArchive(const char *fileName)
+{
+    archive = MappedFile_Open(fileName);
+
+    if (!archive)
+        return false;
+
+    const unsigned char *data = MappedFile_Data(archive);
+    const size_t size = MappedFile_Size(archive);
+    const unsigned char *end = NULL;
+
+    // End of central directory record, followed by an optional comment.
+    for (size_t i = 22; i <= size && i <= 22 + 0xFFFF; ++i)
+    {
+        if (ReadU32(data + size - i) == 0x06054b50)
+        {
+            end = data + size - i;
+            break;
+        }
+    }
+
+    if (!end)
+    {
+        DataZipFile_UnmapArchive();
+        return false;
+    }
+
+    const int count = ReadU16(end + 10);
+    size_t position = ReadU32(end + 16);
+
+    entries = malloc(sizeof (ZipEntry) * (count > 0 ? count : 1));
+    entryCount = 0;
+
+    for (int i = 0; i < count; ++i)
+    {
+        if (position + 46 > size || ReadU32(data + position) != 0x02014b50)
+            break;
+
+        const unsigned char *header = data + position;
+        const Uint16 flags = ReadU16(header + 8);
+        const Uint16 method = ReadU16(header + 10);
+        const Uint32 compressedSize = ReadU32(header + 20);
+        const Uint32 uncompressedSize = ReadU32(header + 24);
+        const Uint16 nameLength = ReadU16(header + 28);
+        const Uint16 extraLength = ReadU16(header + 30);
+        const Uint16 commentLength = ReadU16(header + 32);
+        const Uint32 localOffset = ReadU32(header + 42);
+
+        position += 46 + nameLength + extraLength + commentLength;
+
+        if (localOffset + 30 > size || ReadU32(data + localOffset) != 0x04034b50)
+            continue;
+
+        const size_t offset = localOffset + 30 + ReadU16(data + localOffset + 26) + ReadU16(data + localOffset + 28);
+
+        // Encrypted entries and ZIP64 sizes are left to PhysicsFS.
+        if ((flags & 1) || compressedSize == 0xFFFFFFFF || offset + compressedSize > size)
+            continue;
+
+        entries[entryCount++] = (ZipEntry) {
+            .name = (const char *)header + 46,
+            .nameLength = nameLength,
+            .offset = offset,
+            .size = uncompressedSize,
+            .stored = method == 0 && compressedSize == uncompressedSize,
+        };
+    }
+
+    qsort(entries, entryCount, sizeof (ZipEntry), CompareEntries);
+
+    return true;
+}
+
+void DataZipFile_UnmapArchive()
+{
+    free(entries);
+    MappedFile_Close(archive);
+
+    entries = NULL;
+    entryCount = 0;
+    archive = NULL;
+}
+
+const ZipEntry *DataZipFile_FindEntry(const char *filename)
+{
+    if (!entries)
+        return NULL;
+
+    const ZipEntry key = {.name = filename, .nameLength = strlen(filename)};
+
+    return bsearch(&key, entries, entryCount, sizeof (ZipEntry), CompareEntries);
+}
+
+PooledBuffer *DataZipFile_AcquireBuffer(size_t size)
+{
+    PooledBuffer *best = NULL;
+
+    // Readers may be opened from the asset loader thread.
+    SDL_AtomicLock(&bufferPoolLock);
+
+    for (LinkedListNode *iterator = LinkedList_GetFirst(bufferPool); iterator != NULL;)
+    {
+        PooledBuffer *buffer = LinkedList_GetValuePtr(bufferPool, iterator);
+
+        if (buffer->capacity >= size && (!best || buffer->capacity < best->capacity))
+            best = buffer;
+
+        LinkedList_Next(bufferPool, &iterator);
+    }
+
+    if (best)
+        LinkedList_RemoveFromValuePtr(bufferPool, best);
+
+    SDL_AtomicUnlock(&bufferPoolLock);
+
+    if (best)
+        return best;
+
+    best = malloc(sizeof (PooledBuffer));
+    best->data = malloc(size);
+    best->capacity = size;
+
+    return best;
+}
+
+void DataZipFile_ReleaseBuffer(PooledBuffer *buffer)
+{
+    SDL_AtomicLock(&bufferPoolLock);
+
+    if (LinkedList_GetSize(bufferPool) >= MAX_POOLED_BUFFERS)
+    {
+        // Keep the largest buffers, they are the most expensive to get back.
+        PooledBuffer *smallest = buffer;
+
+        for (LinkedListNode *iterator = LinkedList_GetFirst(bufferPool); iterator != NULL;)
+        {
+            PooledBuffer *pooled = LinkedList_GetValuePtr(bufferPool, iterator);
+
+            if (pooled->capacity < smallest->capacity)
+                smallest = pooled;
+
+            LinkedList_Next(bufferPool, &iterator);
+        }
+
+        if (smallest != buffer)
+        {
+            LinkedList_RemoveFromValuePtr(bufferPool, smallest);
+            LinkedList_PushPtr(bufferPool, buffer);
+        }
+
+        SDL_AtomicUnlock(&bufferPoolLock);
+
+        free(smallest->data);
+        free(smallest);
+
+        return;
+    }
+
+    LinkedList_PushPtr(bufferPool, buffer);
+    SDL_AtomicUnlock(&bufferPoolLock);
+}
+
+static Sint64 PooledRW_Size(SDL_RWops *context)
+{
+    PooledReader *reader = context->hidden.unknown.data1;
+
+    return (Sint64)reader->size;
+}
+
+static Sint64 PooledRW_Seek(SDL_RWops *context, Sint64 offset, int whence)
+{
+    PooledReader *reader = context->hidden.unknown.data1;
+    Sint64 position;
+
+    if (whence == RW_SEEK_SET)
+        position = offset;
+    else if (whence == RW_SEEK_CUR)
+        position = (Sint64)reader->position + offset;
+    else if (whence == RW_SEEK_END)
+        position = (Sint64)reader->size + offset;
+    else
+        return SDL_SetError("Unknown value for 'whence'");
+
+    if (position < 0)
+        position = 0;
+
+    if (position > (Sint64)reader->size)
+        position = (Sint64)reader->size;
+
+    reader->position = (size_t)position;
+
+    return position;
+}
+
+static size_t PooledRW_Read(SDL_RWops *context, void *ptr, size_t size, size_t maxnum)
+{
+    PooledReader *reader = context->hidden.unknown.data1;
+
+    if (size == 0)
+        return 0;
+
+    const size_t available = reader->size - reader->position;
+    const size_t count = SDL_min(maxnum, available / size);
+
+    memcpy(ptr, reader->buffer->data + reader->position, count * size);
+    reader->position += count * size;
+
+    return count;
+}
+
+static size_t ReadOnlyRW_Write(SDL_RWops *context, const void *ptr, size_t size, size_t num)
+{
+    (void)context;(void)ptr;(void)size;(void)num;
+
+    SDL_SetError("Assets from data.zip are read-only");
+
+    return 0;
+}
+
+static int PooledRW_Close(SDL_RWops *context)
+{
+    PooledReader *reader = context->hidden.unknown.data1;
+
+    DataZipFile_ReleaseBuffer(reader->buffer);
+    free(reader);
+    SDL_FreeRW(context);
+
+    return 0;
+}
+
+SDL_RWops *DataZipFile_PooledRW(PooledBuffer *buffer, size_t size)
+{
+    SDL_RWops *context = SDL_AllocRW();
+
+    if (!context)
+    {
+        DataZipFile_ReleaseBuffer(buffer);
+        return NULL;
+    }
+
+    PooledReader *reader = malloc(sizeof (PooledReader));
+
+    reader->buffer = buffer;
+    reader->size = size;
+    reader->position = 0;
+
+    context->size = PooledRW_Size;
+    context->seek = PooledRW_Seek;
+    context->read = PooledRW_Read;
+    context->write = ReadOnlyRW_Write;
+    context->close = PooledRW_Close;
+    context->type = SDL_RWOPS_UNKNOWN;
+    context->hidden.unknown.data1 = reader;
+
+    return context;
+}
+
+static Sint64 PhysFSRW_Size(SDL_RWops *context)
+{
+    return PHYSFS_fileLength(context->hidden.unknown.data1);
+}
+
+static Sint64 PhysFSRW_Seek(SDL_RWops *context, Sint64 offset, int whence)
+{
+    PHYSFS_File *file = context->hidden.unknown.data1;
+    Sint64 position;
+
+    if (whence == RW_SEEK_SET)
+        position = offset;
+    else if (whence == RW_SEEK_CUR)
+        position = PHYSFS_tell(file) + offset;
+    else if (whence == RW_SEEK_END)
+        position = PHYSFS_fileLength(file) + offset;
+    else
+        return SDL_SetError("Unknown value for 'whence'");
+
+    if (position < 0 || !PHYSFS_seek(file, (PHYSFS_uint64)position))
+        return SDL_SetError("PhysicsFS seek failed: %s", PHYSFS_getLastError());
+
+    return position;
+}
+
+static size_t PhysFSRW_Read(SDL_RWops *context, void *ptr, size_t size, size_t maxnum)
+{
+    if (size == 0)
+        return 0;
+
+    const PHYSFS_sint64 readed = PHYSFS_readBytes(context->hidden.unknown.data1, ptr, size * maxnum);
+
+    if (readed < 0)
+    {
+        SDL_SetError("PhysicsFS read failed: %s", PHYSFS_getLastError());
+        return 0;
+    }
+
+    return (size_t)readed / size;
+}
+
+static int PhysFSRW_Close(SDL_RWops *context)
+{
+    const int closed = PHYSFS_close(context->hidden.unknown.data1);
+
+    SDL_FreeRW(context);
+
+    return closed ? 0 : -1;
+}
+
+SDL_RWops *DataZipFile_PhysFSRW(PHYSFS_File *file)
+{
+    SDL_RWops *context = SDL_AllocRW();
+
+    if (!context)
+    {
+        PHYSFS_close(file);
+        return NULL;
+    }
 
-    if (size > 0)
-        return SDL_RWFromConstMem(buffer, size);
+    context->size = PhysFSRW_Size;
+    context->seek = PhysFSRW_Seek;
+    context->read = PhysFSRW_Read;
+    context->write = ReadOnlyRW_Write;
+    context->close = PhysFSRW_Close;
+    context->type = SDL_RWOPS_UNKNOWN;
+    context->hidden.unknown.data1 = file;
 
-    return NULL;
+    return context;
 }
 
 #endif // USE_DATA_ZIP
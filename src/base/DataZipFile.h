@@ -36,7 +36,10 @@ extern "C" {
 bool DataZipFile_Init();
 void DataZipFile_Close();
 int DataZipFile_Read(const char *filename, char **buffer);
+bool DataZipFile_Exists(const char *filename);
+bool DataZipFile_Map(const char *filename, const void **data, size_t *size);
 SDL_RWops *DataZipFile_Load_RW(const char *filename);
+SDL_RWops *DataZipFile_Stream_RW(const char *filename);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,505 @@
+//-------------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Fábio Pichler
+/*-------------------------------------------------------------------------------
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+-------------------------------------------------------------------------------*/
+
+#include "DiskCache.h"
+#include "LinkedList.h"
+#include "private/MappedFile.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <sys/stat.h>
+
+#ifdef _WIN32
+    #include <windows.h>
+    #include <direct.h>
+    #include <process.h>
+    #include <sys/utime.h>
+#else
+    #include <dirent.h>
+    #include <unistd.h>
+    #include <utime.h>
+#endif
+
+#define BLOB_MAGIC 0x4344474du // "MGDC"
+#define BLOB_VERSION 1
+#define BLOB_FORMAT SDL_PIXELFORMAT_ARGB8888
+
+#define CACHE_MAX_BYTES (64ull * 1024 * 1024)
+
+// Temporary files older than this were left behind by a crashed writer.
+#define STALE_TEMPORARY_SECONDS 3600
+
+typedef struct BlobHeader
+{
+    Uint32 magic;
+    Uint32 version;
+    Uint32 format;
+    Uint32 width;
+    Uint32 height;
+    Uint32 pitch;
+    Uint64 key;
+} BlobHeader;
+
+typedef struct MappedBlob
+{
+    Uint64 key;
+    MappedFile *file;
+} MappedBlob;
+
+typedef struct CacheFile
+{
+    char name[64];
+    Uint64 size;
+    Sint64 time;
+} CacheFile;
+
+static char *directory = NULL;
+static LinkedList *mappedBlobs = NULL;
+static SDL_SpinLock mappedBlobsLock = 0;
+static SDL_atomic_t temporaryCounter;
+
+static char *DefaultDirectory();
+static bool MakeDirectories(char *path);
+static void BlobPath(char *path, size_t size, Uint64 key, const char *extension);
+static const BlobHeader *ValidBlob(MappedFile *file, Uint64 key);
+static void Prune();
+static int ListFiles(CacheFile **files);
+static bool HasExtension(const char *name, const char *extension);
+static int CompareFileTimes(const void *a, const void *b);
+
+bool DiskCache_Init(const char *path)
+{
+    DiskCache_Close();
+
+    if (path && *path)
+    {
+        const size_t length = strlen(path);
+
+        directory = malloc(length + 2);
+        memcpy(directory, path, length + 1);
+
+        if (directory[length - 1] != '/' && directory[length - 1] != '\\')
+            strcat(directory, "/");
+    }
+    else if (!(directory = DefaultDirectory()))
+    {
+        return false;
+    }
+
+    if (!MakeDirectories(directory))
+    {
+        printf("Unable to create the image cache directory %s\n", directory);
+        DiskCache_Close();
+
+        return false;
+    }
+
+    mappedBlobs = LinkedList_New();
+
+    Prune();
+
+    return true;
+}
+
+void DiskCache_Close()
+{
+    for (LinkedListNode *iterator = mappedBlobs ? LinkedList_GetFirst(mappedBlobs) : NULL; iterator != NULL;)
+    {
+        MappedBlob *blob = LinkedList_GetValuePtr(mappedBlobs, iterator);
+
+        MappedFile_Close(blob->file);
+        free(blob);
+
+        LinkedList_Next(mappedBlobs, &iterator);
+    }
+
+    LinkedList_Delete(mappedBlobs);
+    free(directory);
+
+    mappedBlobs = NULL;
+    directory = NULL;
+}
+
+bool DiskCache_IsEnabled()
+{
+    return directory != NULL;
+}
+
+Uint64 DiskCache_Hash(const void *data, size_t size)
+{
+    const unsigned char *bytes = data;
+    Uint64 hash = 14695981039346656037ull;
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+
+    return hash;
+}
+
+SDL_Surface *DiskCache_Load(Uint64 key)
+{
+    if (!directory)
+        return NULL;
+
+    MappedFile *file = NULL;
+
+    SDL_AtomicLock(&mappedBlobsLock);
+
+    for (LinkedListNode *iterator = LinkedList_GetFirst(mappedBlobs); iterator != NULL;)
+    {
+        MappedBlob *blob = LinkedList_GetValuePtr(mappedBlobs, iterator);
+
+        if (blob->key == key)
+        {
+            file = blob->file;
+            break;
+        }
+
+        LinkedList_Next(mappedBlobs, &iterator);
+    }
+
+    SDL_AtomicUnlock(&mappedBlobsLock);
+
+    if (!file)
+    {
+        char path[1024];
+
+        BlobPath(path, sizeof (path), key, "rgba");
+
+        if (!(file = MappedFile_Open(path)))
+            return NULL;
+
+        if (!ValidBlob(file, key))
+        {
+            MappedFile_Close(file);
+            remove(path);
+
+            return NULL;
+        }
+
+        // A hit refreshes the modification time, which Prune treats as the last use.
+        utime(path, NULL);
+
+        MappedBlob *blob = malloc(sizeof (MappedBlob));
+
+        blob->key = key;
+        blob->file = file;
+
+        SDL_AtomicLock(&mappedBlobsLock);
+        LinkedList_PushPtr(mappedBlobs, blob);
+        SDL_AtomicUnlock(&mappedBlobsLock);
+    }
+
+    const BlobHeader *header = ValidBlob(file, key);
+
+    return SDL_CreateRGBSurfaceWithFormatFrom((void *)(header + 1), header->width, header->height, 32,
+                                              header->pitch, header->format);
+}
+
+void DiskCache_Store(Uint64 key, SDL_Surface *surface)
+{
+    if (!directory)
+        return;
+
+    SDL_Surface *converted = surface->format->format == BLOB_FORMAT
+            ? surface : SDL_ConvertSurfaceFormat(surface, BLOB_FORMAT, 0);
+
+    if (!converted)
+        return;
+
+    const BlobHeader header = {
+        .magic = BLOB_MAGIC,
+        .version = BLOB_VERSION,
+        .format = BLOB_FORMAT,
+        .width = converted->w,
+        .height = converted->h,
+        .pitch = converted->w * 4,
+        .key = key,
+    };
+
+    char path[1024], temporary[1024], extension[64];
+
+#ifdef _WIN32
+    const int pid = _getpid();
+#else
+    const int pid = (int)getpid();
+#endif
+
+    // Unique per process and store, so concurrent writers never share a temporary file.
+    snprintf(extension, sizeof (extension), "%d-%d.tmp", pid, SDL_AtomicAdd(&temporaryCounter, 1));
+
+    BlobPath(path, sizeof (path), key, "rgba");
+    BlobPath(temporary, sizeof (temporary), key, extension);
+
+    FILE *file = fopen(temporary, "wb");
+    bool ok = file && fwrite(&header, sizeof (header), 1, file) == 1;
+
+    SDL_LockSurface(converted);
+
+    for (int y = 0; ok && y < converted->h; ++y)
+        ok = fwrite((char *)converted->pixels + y * converted->pitch, header.pitch, 1, file) == 1;
+
+    SDL_UnlockSurface(converted);
+
+    if (file)
+        ok = fclose(file) == 0 && ok;
+
+    // Written under a temporary name so a concurrent reader never maps a partial blob.
+    if (!ok || rename(temporary, path) != 0)
+        remove(temporary);
+
+    if (converted != surface)
+        SDL_FreeSurface(converted);
+}
+
+char *DefaultDirectory()
+{
+#if defined(_WIN32) || defined(__ANDROID__)
+    char *prefPath = SDL_GetPrefPath("FabioPichler", "MemoryGame");
+
+    if (!prefPath)
+        return NULL;
+
+    char *path = malloc(strlen(prefPath) + sizeof ("cache/"));
+
+    strcpy(path, prefPath);
+    strcat(path, "cache/");
+    SDL_free(prefPath);
+
+    return path;
+#else
+    const char *base = SDL_getenv("XDG_CACHE_HOME");
+    const char *suffix = "/memory-game/";
+
+    if (!base || !*base)
+    {
+        if (!(base = SDL_getenv("HOME")))
+            return NULL;
+
+        suffix = "/.cache/memory-game/";
+    }
+
+    char *path = malloc(strlen(base) + strlen(suffix) + 1);
+
+    strcpy(path, base);
+    strcat(path, suffix);
+
+    return path;
+#endif
+}
+
+bool MakeDirectories(char *path)
+{
+    for (char *p = path + 1; *p; ++p)
+    {
+        if (*p != '/' && *p != '\\')
+            continue;
+
+        const char separator = *p;
+        *p = '\0';
+
+#ifdef _WIN32
+        _mkdir(path);
+#else
+        mkdir(path, 0755);
+#endif
+
+        *p = separator;
+    }
+
+    // stat() on Windows rejects a trailing separator.
+    const size_t length = strlen(path);
+    const char last = path[length - 1];
+    path[length - 1] = (last == '/' || last == '\\') ? '\0' : last;
+
+#ifdef _WIN32
+    struct _stat info;
+    const bool exists = _stat(path, &info) == 0 && (info.st_mode & _S_IFDIR);
+#else
+    struct stat info;
+    const bool exists = stat(path, &info) == 0 && S_ISDIR(info.st_mode);
+#endif
+
+    path[length - 1] = last;
+
+    return exists;
+}
+
+void BlobPath(char *path, size_t size, Uint64 key, const char *extension)
+{
+    snprintf(path, size, "%s%016llx.%s", directory, (unsigned long long)key, extension);
+}
+
+void Prune()
+{
+    CacheFile *files = NULL;
+    const int count = ListFiles(&files);
+    const Sint64 now = (Sint64)time(NULL);
+    Uint64 total = 0;
+    char path[1024];
+
+    for (int i = 0; i < count; ++i)
+    {
+        if (HasExtension(files[i].name, ".rgba"))
+        {
+            total += files[i].size;
+        }
+        else if (HasExtension(files[i].name, ".tmp") && now - files[i].time > STALE_TEMPORARY_SECONDS)
+        {
+            snprintf(path, sizeof (path), "%s%s", directory, files[i].name);
+            remove(path);
+        }
+    }
+
+    // Least recently used blobs go first until the cache fits the cap.
+    if (total > CACHE_MAX_BYTES)
+    {
+        SDL_qsort(files, count, sizeof (CacheFile), CompareFileTimes);
+
+        for (int i = 0; i < count && total > CACHE_MAX_BYTES; ++i)
+        {
+            if (!HasExtension(files[i].name, ".rgba"))
+                continue;
+
+            snprintf(path, sizeof (path), "%s%s", directory, files[i].name);
+
+            if (remove(path) == 0)
+                total -= files[i].size;
+        }
+    }
+
+    free(files);
+}
+
+int ListFiles(CacheFile **files)
+{
+    int count = 0, capacity = 0;
+
+#ifdef _WIN32
+    char pattern[1024];
+    WIN32_FIND_DATAA data;
+
+    snprintf(pattern, sizeof (pattern), "%s*", directory);
+
+    HANDLE find = FindFirstFileA(pattern, &data);
+
+    if (find == INVALID_HANDLE_VALUE)
+        return 0;
+
+    do
+    {
+        if ((data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) || strlen(data.cFileName) >= sizeof ((*files)->name))
+            continue;
+
+        if (count == capacity)
+        {
+            capacity = capacity ? capacity * 2 : 64;
+            *files = realloc(*files, sizeof (CacheFile) * capacity);
+        }
+
+        CacheFile *file = &(*files)[count++];
+        const Uint64 ticks = (Uint64)data.ftLastWriteTime.dwHighDateTime << 32 | data.ftLastWriteTime.dwLowDateTime;
+
+        strcpy(file->name, data.cFileName);
+        file->size = (Uint64)data.nFileSizeHigh << 32 | data.nFileSizeLow;
+        file->time = (Sint64)(ticks / 10000000ull) - 11644473600ll; // FILETIME counts from 1601.
+    }
+    while (FindNextFileA(find, &data));
+
+    FindClose(find);
+#else
+    DIR *dir = opendir(directory);
+    struct dirent *entry;
+    char path[1024];
+
+    if (!dir)
+        return 0;
+
+    while ((entry = readdir(dir)))
+    {
+        struct stat info;
+
+        if (strlen(entry->d_name) >= sizeof ((*files)->name))
+            continue;
+
+        snprintf(path, sizeof (path), "%s%s", directory, entry->d_name);
+
+        if (stat(path, &info) != 0 || !S_ISREG(info.st_mode))
+            continue;
+
+        if (count == capacity)
+        {
+            capacity = capacity ? capacity * 2 : 64;
+            *files = realloc(*files, sizeof (CacheFile) * capacity);
+        }
+
+        CacheFile *file = &(*files)[count++];
+
+        strcpy(file->name, entry->d_name);
+        file->size = (Uint64)info.st_size;
+        file->time = (Sint64)info.st_mtime;
+    }
+
+    closedir(dir);
+#endif
+
+    return count;
+}
+
+bool HasExtension(const char *name, const char *extension)
+{
+    const size_t length = strlen(name);
+    const size_t extensionLength = strlen(extension);
+
+    return length > extensionLength && strcmp(name + length - extensionLength, extension) == 0;
+}
+
+int CompareFileTimes(const void *a, const void *b)
+{
+    const CacheFile *x = a;
+    const CacheFile *y = b;
+
+    return (x->time > y->time) - (x->time < y->time);
+}
+
+const BlobHeader *ValidBlob(MappedFile *file, Uint64 key)
+{
+    const BlobHeader *header = (const BlobHeader *)MappedFile_Data(file);
+    const size_t size = MappedFile_Size(file);
+
+    if (size < sizeof (BlobHeader)
+            || header->magic != BLOB_MAGIC
+            || header->version != BLOB_VERSION
+            || header->key != key
+            || header->pitch < header->width * 4
+            || size - sizeof (BlobHeader) < (size_t)header->pitch * header->height)
+        return NULL;
+
+    return header;
+}
@@ -0,0 +1,50 @@
+//-------------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Fábio Pichler
+/*-------------------------------------------------------------------------------
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+-------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Persistent cache of decoded images, keyed by a hash of the encoded
+// source bytes, so an edited asset simply misses. Hits are memory-mapped
+// and stay mapped until DiskCache_Close. DiskCache_Init trims the cache
+// to its size cap, dropping the least recently used blobs first, so blobs
+// of edited assets age out.
+
+bool DiskCache_Init(const char *path);
+void DiskCache_Close();
+bool DiskCache_IsEnabled();
+
+Uint64 DiskCache_Hash(const void *data, size_t size);
+SDL_Surface *DiskCache_Load(Uint64 key);
+void DiskCache_Store(Uint64 key, SDL_Surface *surface);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,246 @@
+//-------------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Fábio Pichler
+/*-------------------------------------------------------------------------------
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+-------------------------------------------------------------------------------*/
+
+#include "DisplayList.h"
+#include "Graphics.h"
+#include "RenderBatch.h"
+#include "Texture.h"
+#include "Damage.h"
+
+typedef enum DisplayNodeType
+{
+    DisplayNode_Rect,
+    DisplayNode_Texture,
+    DisplayNode_Callback
+} DisplayNodeType;
+
+typedef struct DisplayNode
+{
+    DisplayNodeType type;
+    bool visible;
+    int layer;
+    SDL_Color color;
+    SDL_FRect rect;
+
+    union
+    {
+        struct
+        {
+            Texture **slot;
+            Texture *source;
+            Uint32 version;
+            bool single;
+            TextureQuad quad;
+        } texture;
+
+        struct
+        {
+            DisplayList_DrawCallback function;
+            void *userdata;
+        } callback;
+    };
+} DisplayNode;
+
+struct DisplayList
+{
+    RenderBatch *batch;
+
+    DisplayNode *nodes;
+    int count;
+    int capacity;
+    int layer;
+};
+
+DisplayNode *DisplayList_PushNode(DisplayList * const self, DisplayNodeType type);
+void DisplayList_DrawTexture(DisplayList * const self, DisplayNode *node);
+
+DisplayList *DisplayList_New(Graphics *graphics)
+{
+    DisplayList * const self = malloc(sizeof (DisplayList));
+
+    self->batch = Graphics_GetRenderBatch(graphics);
+
+    self->nodes = NULL;
+    self->count = 0;
+    self->capacity = 0;
+    self->layer = 0;
+
+    return self;
+}
+
+void DisplayList_Delete(DisplayList * const self)
+{
+    if (!self)
+        return;
+
+    free(self->nodes);
+    free(self);
+}
+
+void DisplayList_Clear(DisplayList * const self)
+{
+    self->count = 0;
+    self->layer = 0;
+    Damage_Invalidate();
+}
+
+void DisplayList_SetLayer(DisplayList * const self, int layer)
+{
+    self->layer = layer;
+}
+
+int DisplayList_GetLayer(DisplayList * const self)
+{
+    return self->layer;
+}
+
+int DisplayList_AddRect(DisplayList * const self, const SDL_FRect *rect, SDL_Color color)
+{
+    DisplayNode *node = DisplayList_PushNode(self, DisplayNode_Rect);
+
+    node->rect = *rect;
+    node->color = color;
+
+    return self->count - 1;
+}
+
+int DisplayList_AddTexture(DisplayList * const self, Texture **texture)
+{
+    DisplayNode *node = DisplayList_PushNode(self, DisplayNode_Texture);
+
+    node->texture.slot = texture;
+    node->texture.source = NULL;
+    node->texture.version = 0;
+    node->texture.single = false;
+
+    return self->count - 1;
+}
+
+int DisplayList_AddCallback(DisplayList * const self, DisplayList_DrawCallback callback, void *userdata)
+{
+    DisplayNode *node = DisplayList_PushNode(self, DisplayNode_Callback);
+
+    node->callback.function = callback;
+    node->callback.userdata = userdata;
+
+    return self->count - 1;
+}
+
+void DisplayList_SetRect(DisplayList * const self, int node, const SDL_FRect *rect)
+{
+    self->nodes[node].rect = *rect;
+}
+
+void DisplayList_SetColor(DisplayList * const self, int node, SDL_Color color)
+{
+    self->nodes[node].color = color;
+}
+
+void DisplayList_SetVisible(DisplayList * const self, int node, bool visible)
+{
+    if (self->nodes[node].visible != visible)
+        Damage_Invalidate();
+
+    self->nodes[node].visible = visible;
+}
+
+void DisplayList_Draw(DisplayList * const self)
+{
+    for (int i = 0; i < self->count; ++i)
+    {
+        DisplayNode *node = &self->nodes[i];
+
+        if (!node->visible)
+            continue;
+
+        RenderBatch_SetLayer(self->batch, node->layer);
+
+        switch (node->type)
+        {
+        case DisplayNode_Rect:
+            RenderBatch_AddRect(self->batch, &node->rect, node->color);
+            break;
+
+        case DisplayNode_Texture:
+            DisplayList_DrawTexture(self, node);
+            break;
+
+        case DisplayNode_Callback:
+            node->callback.function(node->callback.userdata);
+            break;
+        }
+    }
+}
+
+void DisplayList_DrawTexture(DisplayList * const self, DisplayNode *node)
+{
+    Texture *texture = *node->texture.slot;
+
+    if (!texture)
+        return;
+
+    Uint32 version = Texture_Touch(texture);
+
+    // Resolved again only when the slot holds another texture or this one changed.
+    if (texture != node->texture.source || version != node->texture.version)
+    {
+        node->texture.single = Texture_GetQuad(texture, &node->texture.quad);
+
+        // Resolving may sync a new cache rect into the texture.
+        version = Texture_Touch(texture);
+
+        node->texture.source = texture;
+        node->texture.version = version;
+    }
+
+    const TextureQuad *quad = &node->texture.quad;
+
+    if (!node->texture.single)
+        Texture_Draw(texture);
+    else if (quad->texture)
+        RenderBatch_AddSprite(self->batch, quad->texture, &quad->srcrect, &quad->dstrect, quad->color);
+    else
+        RenderBatch_AddRect(self->batch, &quad->dstrect, quad->color);
+}
+
+DisplayNode *DisplayList_PushNode(DisplayList * const self, DisplayNodeType type)
+{
+    if (self->count == self->capacity)
+    {
+        self->capacity = self->capacity ? self->capacity * 2 : 64;
+        self->nodes = realloc(self->nodes, sizeof (DisplayNode) * self->capacity);
+    }
+
+    DisplayNode *node = &self->nodes[self->count++];
+
+    node->type = type;
+    node->visible = true;
+    node->layer = self->layer;
+    node->color = (SDL_Color) {0, 0, 0, 0};
+    node->rect = (SDL_FRect) {0.f, 0.f, 0.f, 0.f};
+
+    Damage_Invalidate();
+
+    return node;
+}
@@ -0,0 +1,68 @@
+//-------------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Fábio Pichler
+/*-------------------------------------------------------------------------------
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+-------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Retained draw order for a scene. Widgets add their nodes once and push
+// updates when their state changes; DisplayList_Draw walks the flat node
+// array in order. Texture nodes point at the widget's texture slot, so
+// swapping the texture in the slot needs no update; they keep the quad
+// from Texture_GetQuad and resolve it again only when the slot or the
+// texture's version changes. Text and rotated textures still go through
+// Texture_Draw. Each node keeps the layer that was current when it was
+// added; the render batch may reorder nodes within a layer, so widgets
+// put overlapping parts on higher layers.
+
+typedef struct DisplayList DisplayList;
+typedef struct Texture Texture;
+typedef struct Graphics Graphics;
+typedef void (*DisplayList_DrawCallback)(void *userdata);
+
+DisplayList *DisplayList_New(Graphics *graphics);
+void DisplayList_Delete(DisplayList * const self);
+void DisplayList_Clear(DisplayList * const self);
+
+void DisplayList_SetLayer(DisplayList * const self, int layer);
+int DisplayList_GetLayer(DisplayList * const self);
+
+int DisplayList_AddRect(DisplayList * const self, const SDL_FRect *rect, SDL_Color color);
+int DisplayList_AddTexture(DisplayList * const self, Texture **texture);
+int DisplayList_AddCallback(DisplayList * const self, DisplayList_DrawCallback callback, void *userdata);
+
+void DisplayList_SetRect(DisplayList * const self, int node, const SDL_FRect *rect);
+void DisplayList_SetColor(DisplayList * const self, int node, SDL_Color color);
+void DisplayList_SetVisible(DisplayList * const self, int node, bool visible);
+
+void DisplayList_Draw(DisplayList * const self);
+
+#ifdef __cplusplus
+}
+#endif
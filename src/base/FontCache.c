@@ -0,0 +1,289 @@
+//-------------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Fábio Pichler
+/*-------------------------------------------------------------------------------
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+-------------------------------------------------------------------------------*/
+
+#include "FontCache.h"
+#include "AssetPack.h"
+#include "DataZipFile.h"
+#include "LinkedList.h"
+
+#include <stdio.h>
+#include <string.h>
+
+typedef struct FontData
+{
+    char *fileName;
+    const char *buffer;
+    size_t size;
+    bool owned;
+} FontData;
+
+typedef struct FontEntry
+{
+    FontData *data;
+    TTF_Font *font;
+    int ptsize;
+    int refCount;
+} FontEntry;
+
+static LinkedList *fontData = NULL;
+static LinkedList *fontEntries = NULL;
+static SDL_SpinLock fontDataLock = 0;
+
+static FontData *GetFontData(const char *fileName);
+static FontData *FindFontData(const char *fileName);
+static FontEntry *FindEntry(const char *fileName, int ptsize);
+static char *ReadFontFile(const char *fileName, size_t *size);
+
+bool FontCache_Preload(const char *fileName)
+{
+    return GetFontData(fileName) != NULL;
+}
+
+TTF_Font *FontCache_Acquire(const char *fileName, int ptsize)
+{
+    if (!fontEntries)
+        fontEntries = LinkedList_New();
+
+    FontEntry *entry = FindEntry(fileName, ptsize);
+
+    if (!entry)
+    {
+        FontData *data = GetFontData(fileName);
+
+        if (!data)
+            return NULL;
+
+        TTF_Font *font = TTF_OpenFontRW(SDL_RWFromConstMem(data->buffer, (int)data->size), 1, ptsize);
+
+        if (!font)
+            return NULL;
+
+        entry = malloc(sizeof (FontEntry));
+
+        entry->data = data;
+        entry->font = font;
+        entry->ptsize = ptsize;
+        entry->refCount = 0;
+
+        LinkedList_PushPtr(fontEntries, entry);
+    }
+
+    entry->refCount++;
+
+    return entry->font;
+}
+
+void FontCache_Release(TTF_Font *font)
+{
+    if (!font || !fontEntries)
+        return;
+
+    for (LinkedListNode *iterator = LinkedList_GetFirst(fontEntries); iterator != NULL;)
+    {
+        FontEntry *entry = LinkedList_GetValuePtr(fontEntries, iterator);
+
+        if (entry->font == font)
+        {
+            // The last holder closes the font; the file stays in memory for the next open.
+            if (--entry->refCount <= 0)
+            {
+                TTF_CloseFont(entry->font);
+                free(entry);
+
+                LinkedList_Remove(fontEntries, &iterator);
+            }
+
+            return;
+        }
+
+        LinkedList_Next(fontEntries, &iterator);
+    }
+}
+
+void FontCache_Clear()
+{
+    for (LinkedListNode *iterator = fontEntries ? LinkedList_GetFirst(fontEntries) : NULL; iterator != NULL;)
+    {
+        FontEntry *entry = LinkedList_GetValuePtr(fontEntries, iterator);
+
+        TTF_CloseFont(entry->font);
+        free(entry);
+
+        LinkedList_Next(fontEntries, &iterator);
+    }
+
+    SDL_AtomicLock(&fontDataLock);
+
+    for (LinkedListNode *iterator = fontData ? LinkedList_GetFirst(fontData) : NULL; iterator != NULL;)
+    {
+        FontData *data = LinkedList_GetValuePtr(fontData, iterator);
+
+        if (data->owned)
+            free((char *)data->buffer);
+
+        free(data->fileName);
+        free(data);
+
+        LinkedList_Next(fontData, &iterator);
+    }
+
+    LinkedList_Delete(fontEntries);
+    LinkedList_Delete(fontData);
+
+    fontEntries = NULL;
+    fontData = NULL;
+
+    SDL_AtomicUnlock(&fontDataLock);
+}
+
+FontData *GetFontData(const char *fileName)
+{
+    SDL_AtomicLock(&fontDataLock);
+    FontData *data = FindFontData(fileName);
+    SDL_AtomicUnlock(&fontDataLock);
+
+    if (data)
+        return data;
+
+    const char *buffer = NULL;
+    size_t size = 0;
+    bool owned = false;
+    const void *mapped;
+
+    if (AssetPack_Map(fileName, &mapped, &size))
+        buffer = mapped;
+
+#ifdef USE_DATA_ZIP
+    // Stored entries are used straight from the memory-mapped data.zip.
+    if (!buffer && DataZipFile_Map(fileName, &mapped, &size))
+        buffer = mapped;
+#endif
+
+    if (!buffer)
+    {
+        if (!(buffer = ReadFontFile(fileName, &size)))
+            return NULL;
+
+        owned = true;
+    }
+
+    // The file is read without holding the lock, so another thread may have won the race.
+    SDL_AtomicLock(&fontDataLock);
+
+    if ((data = FindFontData(fileName)))
+    {
+        SDL_AtomicUnlock(&fontDataLock);
+
+        if (owned)
+            free((char *)buffer);
+
+        return data;
+    }
+
+    data = malloc(sizeof (FontData));
+    const size_t length = strlen(fileName) + 1;
+
+    data->fileName = malloc(length);
+    data->buffer = buffer;
+    data->size = size;
+    data->owned = owned;
+
+    memcpy(data->fileName, fileName, length);
+
+    if (!fontData)
+        fontData = LinkedList_New();
+
+    LinkedList_PushPtr(fontData, data);
+    SDL_AtomicUnlock(&fontDataLock);
+
+    return data;
+}
+
+FontData *FindFontData(const char *fileName)
+{
+    if (!fontData)
+        return NULL;
+
+    for (LinkedListNode *iterator = LinkedList_GetFirst(fontData); iterator != NULL;)
+    {
+        FontData *data = LinkedList_GetValuePtr(fontData, iterator);
+
+        if (strcmp(data->fileName, fileName) == 0)
+            return data;
+
+        LinkedList_Next(fontData, &iterator);
+    }
+
+    return NULL;
+}
+
+FontEntry *FindEntry(const char *fileName, int ptsize)
+{
+    for (LinkedListNode *iterator = LinkedList_GetFirst(fontEntries); iterator != NULL;)
+    {
+        FontEntry *entry = LinkedList_GetValuePtr(fontEntries, iterator);
+
+        if (entry->ptsize == ptsize && strcmp(entry->data->fileName, fileName) == 0)
+            return entry;
+
+        LinkedList_Next(fontEntries, &iterator);
+    }
+
+    return NULL;
+}
+
+char *ReadFontFile(const char *fileName, size_t *size)
+{
+#ifdef USE_DATA_ZIP
+    char *buffer;
+    int length = DataZipFile_Read(fileName, &buffer);
+
+    *size = length;
+
+    return length > 0 ? buffer : NULL;
+#else
+    SDL_RWops *file = SDL_RWFromFile(fileName, "rb");
+
+    if (!file)
+    {
+        printf("Failed to open font %s! SDL Error: %s\n", fileName, SDL_GetError());
+        return NULL;
+    }
+
+    const Sint64 length = SDL_RWsize(file);
+    char *buffer = length > 0 ? malloc(length) : NULL;
+
+    if (buffer && SDL_RWread(file, buffer, 1, length) != (size_t)length)
+    {
+        free(buffer);
+        buffer = NULL;
+    }
+
+    SDL_RWclose(file);
+
+    *size = buffer ? (size_t)length : 0;
+
+    return buffer;
+#endif
+}
@@ -0,0 +1,49 @@
+//-------------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Fábio Pichler
+/*-------------------------------------------------------------------------------
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+-------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <SDL2/SDL_ttf.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Process-wide cache of opened fonts, keyed by (file, point size).
+// The font file is read once and every size is opened from that memory.
+// Each FontCache_Acquire needs a FontCache_Release; the font is closed
+// when its last holder (a GlyphAtlas) lets go, the file data stays until
+// FontCache_Clear.
+// FontCache_Preload may run on a loader thread; everything else belongs
+// to the main thread.
+
+bool FontCache_Preload(const char *fileName);
+TTF_Font *FontCache_Acquire(const char *fileName, int ptsize);
+void FontCache_Release(TTF_Font *font);
+void FontCache_Clear();
+
+#ifdef __cplusplus
+}
+#endif
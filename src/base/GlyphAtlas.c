@@ -0,0 +1,387 @@
+//-------------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Fábio Pichler
+/*-------------------------------------------------------------------------------
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+-------------------------------------------------------------------------------*/
+
+#include "GlyphAtlas.h"
+#include "FontCache.h"
+#include "RectPacker.h"
+#include "RenderBatch.h"
+
+#include <SDL2/SDL_ttf.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#define DIRECT_GLYPHS 256
+
+typedef struct Glyph
+{
+    SDL_Rect rect;
+    int offsetX;
+    int advance;
+    bool loaded;
+    bool failed;
+} Glyph;
+
+typedef struct ExtraGlyph
+{
+    Uint32 codepoint;
+    Glyph glyph;
+} ExtraGlyph;
+
+struct GlyphAtlas
+{
+    SDL_Renderer *renderer;
+    RenderBatch *batch;
+    TTF_Font *font;
+    char *fileName;
+    int ptsize;
+    int lineHeight;
+
+    SDL_Surface *surface;
+    SDL_Texture *texture;
+    RectPacker *packer;
+
+    Glyph glyphs[DIRECT_GLYPHS];
+    ExtraGlyph *extraGlyphs;
+    int extraCount;
+    int extraCapacity;
+};
+
+void GlyphAtlas_Layout(GlyphAtlas * const self, const char *text, int *minX, int *width);
+Glyph *GlyphAtlas_GetGlyph(GlyphAtlas * const self, Uint32 codepoint);
+bool GlyphAtlas_LoadGlyph(GlyphAtlas * const self, Uint32 codepoint, Glyph *glyph);
+bool GlyphAtlas_Grow(GlyphAtlas * const self);
+bool GlyphAtlas_CreateTexture(GlyphAtlas * const self);
+
+static Uint32 NextCodepoint(const char **text);
+
+GlyphAtlas *GlyphAtlas_New(SDL_Renderer *renderer, RenderBatch *batch, const char *fileName, int ptsize)
+{
+    TTF_Font *font = FontCache_Acquire(fileName, ptsize);
+
+    if (!font)
+        return NULL;
+
+    GlyphAtlas * const self = malloc(sizeof (GlyphAtlas));
+    const size_t length = strlen(fileName) + 1;
+    const int size = ptsize > 24 ? 512 : 256;
+
+    self->renderer = renderer;
+    self->batch = batch;
+    self->font = font;
+    self->fileName = malloc(length);
+    self->ptsize = ptsize;
+    self->lineHeight = TTF_FontHeight(font);
+
+    memcpy(self->fileName, fileName, length);
+
+    self->surface = SDL_CreateRGBSurfaceWithFormat(0, size, size, 32, SDL_PIXELFORMAT_ARGB8888);
+    self->texture = NULL;
+    self->packer = RectPacker_New(size, size, 1);
+
+    memset(self->glyphs, 0, sizeof (self->glyphs));
+    self->extraGlyphs = NULL;
+    self->extraCount = 0;
+    self->extraCapacity = 0;
+
+    if (self->surface)
+    {
+        SDL_FillRect(self->surface, NULL, 0);
+        GlyphAtlas_CreateTexture(self);
+    }
+    else
+    {
+        printf("Unable to create glyph atlas surface! SDL Error: %s\n", SDL_GetError());
+    }
+
+    // Printable ASCII is rasterized up front, so counters never upload.
+    for (Uint32 codepoint = 32; codepoint < 127; ++codepoint)
+        GlyphAtlas_GetGlyph(self, codepoint);
+
+    return self;
+}
+
+void GlyphAtlas_Delete(GlyphAtlas * const self)
+{
+    if (!self)
+        return;
+
+    FontCache_Release(self->font);
+
+    SDL_FreeSurface(self->surface);
+    SDL_DestroyTexture(self->texture);
+    RectPacker_Delete(self->packer);
+
+    free(self->fileName);
+    free(self->extraGlyphs);
+    free(self);
+}
+
+bool GlyphAtlas_Matches(GlyphAtlas * const self, const char *fileName, int ptsize)
+{
+    return self->ptsize == ptsize && strcmp(self->fileName, fileName) == 0;
+}
+
+void GlyphAtlas_MeasureText(GlyphAtlas * const self, const char *text, int *w, int *h)
+{
+    int minX;
+
+    GlyphAtlas_Layout(self, text, &minX, w);
+    *h = self->lineHeight;
+}
+
+void GlyphAtlas_DrawText(GlyphAtlas * const self, const char *text, const SDL_FRect *rect, SDL_Color color)
+{
+    int minX, textW;
+
+    GlyphAtlas_Layout(self, text, &minX, &textW);
+
+    if (!self->texture || textW == 0)
+        return;
+
+    const float scaleX = rect->w / textW;
+    const float scaleY = rect->h / self->lineHeight;
+
+    int pen = 0;
+    Uint32 previous = 0;
+
+    while (*text)
+    {
+        const Uint32 codepoint = NextCodepoint(&text);
+        Glyph *glyph = GlyphAtlas_GetGlyph(self, codepoint);
+
+        if (!glyph)
+            continue;
+
+        if (previous)
+            pen += TTF_GetFontKerningSizeGlyphs32(self->font, previous, codepoint);
+
+        previous = codepoint;
+
+        if (glyph->rect.w > 0 && glyph->rect.h > 0)
+        {
+            const SDL_FRect quad = {
+                rect->x + (pen + glyph->offsetX - minX) * scaleX,
+                rect->y,
+                glyph->rect.w * scaleX,
+                glyph->rect.h * scaleY,
+            };
+
+            // Text shares the frame's sort with everything else drawn from this atlas.
+            RenderBatch_AddSprite(self->batch, self->texture, &glyph->rect, &quad, color);
+        }
+
+        pen += glyph->advance;
+    }
+}
+
+void GlyphAtlas_Layout(GlyphAtlas * const self, const char *text, int *minX, int *width)
+{
+    int pen = 0, maxX = 0;
+    Uint32 previous = 0;
+
+    *minX = 0;
+
+    while (text && *text)
+    {
+        const Uint32 codepoint = NextCodepoint(&text);
+        Glyph *glyph = GlyphAtlas_GetGlyph(self, codepoint);
+
+        if (!glyph)
+            continue;
+
+        if (previous)
+            pen += TTF_GetFontKerningSizeGlyphs32(self->font, previous, codepoint);
+
+        const int left = pen + glyph->offsetX;
+
+        *minX = SDL_min(*minX, left);
+        maxX = SDL_max(maxX, SDL_max(left + glyph->rect.w, pen + glyph->advance));
+        pen += glyph->advance;
+        previous = codepoint;
+    }
+
+    *width = maxX - *minX;
+}
+
+Glyph *GlyphAtlas_GetGlyph(GlyphAtlas * const self, Uint32 codepoint)
+{
+    Glyph *glyph = NULL;
+
+    if (codepoint < DIRECT_GLYPHS)
+    {
+        glyph = &self->glyphs[codepoint];
+    }
+    else
+    {
+        for (int i = 0; i < self->extraCount; ++i)
+            if (self->extraGlyphs[i].codepoint == codepoint)
+                return &self->extraGlyphs[i].glyph;
+
+        if (self->extraCount == self->extraCapacity)
+        {
+            self->extraCapacity = self->extraCapacity ? self->extraCapacity * 2 : 16;
+            self->extraGlyphs = realloc(self->extraGlyphs, sizeof (ExtraGlyph) * self->extraCapacity);
+        }
+
+        ExtraGlyph *extra = &self->extraGlyphs[self->extraCount++];
+
+        extra->codepoint = codepoint;
+        extra->glyph = (Glyph) {{0, 0, 0, 0}, 0, 0, false, false};
+        glyph = &extra->glyph;
+    }
+
+    if (glyph->failed)
+        return NULL;
+
+    if (!glyph->loaded && !GlyphAtlas_LoadGlyph(self, codepoint, glyph))
+    {
+        glyph->failed = true;
+        return NULL;
+    }
+
+    return glyph;
+}
+
+bool GlyphAtlas_LoadGlyph(GlyphAtlas * const self, Uint32 codepoint, Glyph *glyph)
+{
+    int minX, maxX, minY, maxY, advance;
+
+    if (!self->surface || TTF_GlyphMetrics32(self->font, codepoint, &minX, &maxX, &minY, &maxY, &advance) != 0)
+        return false;
+
+    SDL_Surface *surface = TTF_RenderGlyph32_Blended(self->font, codepoint, (SDL_Color) {255, 255, 255, 255});
+
+    if (!surface)
+    {
+        printf("Unable to render glyph %u! SDL_ttf Error: %s\n", codepoint, TTF_GetError());
+        return false;
+    }
+
+    SDL_Rect rect;
+
+    while (!RectPacker_Pack(self->packer, surface->w, surface->h, &rect))
+    {
+        if (!GlyphAtlas_Grow(self))
+        {
+            SDL_FreeSurface(surface);
+            return false;
+        }
+    }
+
+    SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_NONE);
+    SDL_BlitSurface(surface, NULL, self->surface, &rect);
+    SDL_FreeSurface(surface);
+
+    if (self->texture)
+    {
+        const Uint8 *pixels = (const Uint8 *)self->surface->pixels + (rect.y * self->surface->pitch) + (rect.x * 4);
+        SDL_UpdateTexture(self->texture, &rect, pixels, self->surface->pitch);
+    }
+
+    glyph->rect = rect;
+    glyph->offsetX = SDL_min(0, minX);
+    glyph->advance = advance;
+    glyph->loaded = true;
+
+    return true;
+}
+
+bool GlyphAtlas_Grow(GlyphAtlas * const self)
+{
+    SDL_RendererInfo info;
+    int w = self->surface->w;
+    int h = self->surface->h;
+
+    if (w > h)
+        h *= 2;
+    else
+        w *= 2;
+
+    if (SDL_GetRendererInfo(self->renderer, &info) == 0
+            && ((info.max_texture_width > 0 && w > info.max_texture_width)
+                || (info.max_texture_height > 0 && h > info.max_texture_height)))
+    {
+        printf("Glyph atlas for %s (%d) is full.\n", self->fileName, self->ptsize);
+        return false;
+    }
+
+    SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, SDL_PIXELFORMAT_ARGB8888);
+
+    if (!surface)
+        return false;
+
+    SDL_FillRect(surface, NULL, 0);
+    SDL_SetSurfaceBlendMode(self->surface, SDL_BLENDMODE_NONE);
+    SDL_BlitSurface(self->surface, NULL, surface, NULL);
+    SDL_FreeSurface(self->surface);
+
+    self->surface = surface;
+    RectPacker_Resize(self->packer, w, h);
+
+    return GlyphAtlas_CreateTexture(self);
+}
+
+bool GlyphAtlas_CreateTexture(GlyphAtlas * const self)
+{
+    // Glyphs already recorded in the batch still point at the old texture.
+    RenderBatch_Flush(self->batch);
+    SDL_DestroyTexture(self->texture);
+
+    self->texture = SDL_CreateTexture(self->renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC,
+                                      self->surface->w, self->surface->h);
+
+    if (!self->texture)
+    {
+        printf("Unable to create glyph atlas texture! SDL Error: %s\n", SDL_GetError());
+        return false;
+    }
+
+    SDL_SetTextureBlendMode(self->texture, SDL_BLENDMODE_BLEND);
+    SDL_UpdateTexture(self->texture, NULL, self->surface->pixels, self->surface->pitch);
+
+    return true;
+}
+
+Uint32 NextCodepoint(const char **text)
+{
+    const Uint8 *s = (const Uint8 *)*text;
+    Uint32 codepoint;
+    int length;
+
+    if (s[0] < 0x80)
+        codepoint = s[0], length = 1;
+    else if ((s[0] & 0xE0) == 0xC0 && s[1])
+        codepoint = ((s[0] & 0x1F) << 6) | (s[1] & 0x3F), length = 2;
+    else if ((s[0] & 0xF0) == 0xE0 && s[1] && s[2])
+        codepoint = ((s[0] & 0x0F) << 12) | ((s[1] & 0x3F) << 6) | (s[2] & 0x3F), length = 3;
+    else if ((s[0] & 0xF8) == 0xF0 && s[1] && s[2] && s[3])
+        codepoint = ((s[0] & 0x07) << 18) | ((s[1] & 0x3F) << 12) | ((s[2] & 0x3F) << 6) | (s[3] & 0x3F), length = 4;
+    else
+        codepoint = 0xFFFD, length = 1;
+
+    *text += length;
+
+    return codepoint;
+}
@@ -0,0 +1,49 @@
+//-------------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Fábio Pichler
+/*-------------------------------------------------------------------------------
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+-------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Text renderer for one (font, size). Glyphs are rasterized once into an
+// atlas texture and strings are recorded as quads into the render batch.
+
+typedef struct GlyphAtlas GlyphAtlas;
+typedef struct RenderBatch RenderBatch;
+
+GlyphAtlas *GlyphAtlas_New(SDL_Renderer *renderer, RenderBatch *batch, const char *fileName, int ptsize);
+void GlyphAtlas_Delete(GlyphAtlas * const self);
+
+bool GlyphAtlas_Matches(GlyphAtlas * const self, const char *fileName, int ptsize);
+void GlyphAtlas_MeasureText(GlyphAtlas * const self, const char *text, int *w, int *h);
+void GlyphAtlas_DrawText(GlyphAtlas * const self, const char *text, const SDL_FRect *rect, SDL_Color color);
+
+#ifdef __cplusplus
+}
+#endif
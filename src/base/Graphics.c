@@ -23,12 +23,22 @@ SOFTWARE.
 -------------------------------------------------------------------------------*/
 
 #include "Graphics.h"
+#include "AssetLoader.h"
+#include "TextureCache.h"
+#include "GlyphAtlas.h"
+#include "RenderBatch.h"
+#include "LinkedList.h"
 
 #include <stdio.h>
 
 struct Graphics
 {
     SDL_Renderer *renderer;
+    AssetLoader *assetLoader;
+    TextureCache *textureCache;
+    LinkedList *glyphAtlases;
+    RenderBatch *renderBatch;
+    float outputScale;
 };
 
 Graphics *Graphics_New(Window *window)
@@ -38,7 +48,7 @@ Graphics *Graphics_New(Window *window)
     self->renderer = SDL_CreateRenderer(
                 Window_GetSDLWindow(window),
                 -1,
-                SDL_RENDERER_TARGETTEXTURE | SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+                SDL_RENDERER_TARGETTEXTURE | SDL_RENDERER_ACCELERATED);
 
     if (!self->renderer)
     {
@@ -51,6 +61,14 @@ Graphics *Graphics_New(Window *window)
     SDL_Rect rect = Window_GetRect(window);
     SetRenderLogicalSize(self, rect.w, rect.h);
 
+    self->assetLoader = AssetLoader_New();
+    self->textureCache = TextureCache_New(self->renderer, self->assetLoader);
+    self->glyphAtlases = LinkedList_New();
+    self->renderBatch = RenderBatch_New(self->renderer);
+    self->outputScale = 1.f;
+
+    Graphics_UpdateOutputScale(self);
+
     return self;
 }
 
@@ -59,6 +77,20 @@ void Graphics_Delete(Graphics * const self)
     if (!self)
         return;
 
+    for (LinkedListNode *iterator = LinkedList_GetFirst(self->glyphAtlases); iterator != NULL;)
+    {
+        GlyphAtlas_Delete(LinkedList_GetValuePtr(self->glyphAtlases, iterator));
+        LinkedList_Next(self->glyphAtlases, &iterator);
+    }
+
+    LinkedList_Delete(self->glyphAtlases);
+
+    // Stop the loader first so no upload callback can reach a deleted cache.
+    AssetLoader_Delete(self->assetLoader);
+    TextureCache_Delete(self->textureCache);
+
+    // Atlases unregister their white texel from the batch when deleted.
+    RenderBatch_Delete(self->renderBatch);
     SDL_DestroyRenderer(self->renderer);
 
     free(self);
@@ -69,6 +101,72 @@ SDL_Renderer *Graphics_GetRenderer(Graphics * const self)
     return self->renderer;
 }
 
+AssetLoader *Graphics_GetAssetLoader(Graphics * const self)
+{
+    return self->assetLoader;
+}
+
+TextureCache *Graphics_GetTextureCache(Graphics * const self)
+{
+    return self->textureCache;
+}
+
+GlyphAtlas *Graphics_GetGlyphAtlas(Graphics * const self, const char *fileName, int ptsize)
+{
+    for (LinkedListNode *iterator = LinkedList_GetFirst(self->glyphAtlases); iterator != NULL;)
+    {
+        GlyphAtlas *glyphAtlas = LinkedList_GetValuePtr(self->glyphAtlases, iterator);
+
+        if (GlyphAtlas_Matches(glyphAtlas, fileName, ptsize))
+            return glyphAtlas;
+
+        LinkedList_Next(self->glyphAtlases, &iterator);
+    }
+
+    GlyphAtlas *glyphAtlas = GlyphAtlas_New(self->renderer, self->renderBatch, fileName, ptsize);
+
+    if (glyphAtlas)
+        LinkedList_PushPtr(self->glyphAtlases, glyphAtlas);
+
+    return glyphAtlas;
+}
+
+RenderBatch *Graphics_GetRenderBatch(Graphics * const self)
+{
+    return self->renderBatch;
+}
+
+void Graphics_UpdateOutputScale(Graphics * const self)
+{
+    int outputW, outputH, logicalW, logicalH;
+
+    SDL_RenderGetLogicalSize(self->renderer, &logicalW, &logicalH);
+
+    if (SDL_GetRendererOutputSize(self->renderer, &outputW, &outputH) != 0 || logicalW <= 0 || logicalH <= 0)
+        return;
+
+    // Same letterbox fit as SDL_RenderSetLogicalSize: output pixels per logical pixel.
+    self->outputScale = SDL_min((float)outputW / logicalW, (float)outputH / logicalH);
+
+    TextureCache_SetOutputScale(self->textureCache, self->outputScale);
+}
+
+float Graphics_GetOutputScale(Graphics * const self)
+{
+    return self->outputScale;
+}
+
+bool Graphics_SetVSync(Graphics * const self, bool vsync)
+{
+    if (SDL_RenderSetVSync(self->renderer, vsync ? 1 : 0) != 0)
+    {
+        printf("Unable to change vsync! SDL Error: %s\n", SDL_GetError());
+        return false;
+    }
+
+    return true;
+}
+
 int SetRenderLogicalSize(Graphics * const self, int w, int h)
 {
     return SDL_RenderSetLogicalSize(self->renderer, w, h);
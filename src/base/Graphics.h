@@ -27,16 +27,28 @@ SOFTWARE.
 #include "Window.h"
 
 #include <SDL2/SDL.h>
+#include <stdbool.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 typedef struct Graphics Graphics;
+typedef struct AssetLoader AssetLoader;
+typedef struct TextureCache TextureCache;
+typedef struct GlyphAtlas GlyphAtlas;
+typedef struct RenderBatch RenderBatch;
 
 Graphics *Graphics_New(Window *window);
 void Graphics_Delete(Graphics * const self);
 SDL_Renderer *Graphics_GetRenderer(Graphics * const self);
+AssetLoader *Graphics_GetAssetLoader(Graphics * const self);
+TextureCache *Graphics_GetTextureCache(Graphics * const self);
+GlyphAtlas *Graphics_GetGlyphAtlas(Graphics * const self, const char *fileName, int ptsize);
+RenderBatch *Graphics_GetRenderBatch(Graphics * const self);
+void Graphics_UpdateOutputScale(Graphics * const self);
+float Graphics_GetOutputScale(Graphics * const self);
+bool Graphics_SetVSync(Graphics * const self, bool vsync);
 int SetRenderLogicalSize(Graphics * const self, int w, int h);
 
 #ifdef __cplusplus
@@ -0,0 +1,157 @@
+//-------------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Fábio Pichler
+/*-------------------------------------------------------------------------------
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+-------------------------------------------------------------------------------*/
+
+#include "ImageLoader.h"
+#include "AssetPack.h"
+#include "DataZipFile.h"
+#include "DiskCache.h"
+#include "Qoi.h"
+
+#include <SDL2/SDL_image.h>
+
+#include <string.h>
+
+static SDL_Surface *LoadFile(const char *fileName);
+#ifdef PREFER_QOI
+static SDL_Surface *LoadQoiVariant(const char *fileName);
+#endif
+static SDL_Surface *LoadCached(const char *fileName);
+static SDL_RWops *OpenSource(const char *fileName);
+
+SDL_Surface *ImageLoader_Load(const char *fileName)
+{
+    SDL_Surface *surface = AssetPack_LoadSurface(fileName);
+
+    if (surface)
+        return surface;
+
+#ifdef PREFER_QOI
+    if ((surface = LoadQoiVariant(fileName)))
+        return surface;
+#endif
+
+    return LoadFile(fileName);
+}
+
+SDL_Surface *LoadFile(const char *fileName)
+{
+    if (DiskCache_IsEnabled())
+        return LoadCached(fileName);
+
+    SDL_RWops *source = OpenSource(fileName);
+
+    if (Qoi_IsQoi(source))
+        return Qoi_Load_RW(source, 1);
+
+    return IMG_Load_RW(source, 1);
+}
+
+#ifdef PREFER_QOI
+SDL_Surface *LoadQoiVariant(const char *fileName)
+{
+    const size_t length = strlen(fileName);
+
+    if (length < 4 || SDL_strcasecmp(fileName + length - 4, ".png") != 0)
+        return NULL;
+
+    char *qoiName = malloc(length + 1);
+    SDL_Surface *surface = NULL;
+
+    memcpy(qoiName, fileName, length - 4);
+    memcpy(qoiName + length - 4, ".qoi", 5);
+
+#ifdef USE_DATA_ZIP
+    // PhysicsFS reports every missing file, so check before opening.
+    if (DataZipFile_Exists(qoiName))
+#endif
+        surface = LoadFile(qoiName);
+
+    free(qoiName);
+
+    return surface;
+}
+#endif
+
+SDL_Surface *LoadCached(const char *fileName)
+{
+    const void *data = NULL;
+    void *buffer = NULL;
+    size_t size = 0;
+
+#ifdef USE_DATA_ZIP
+    DataZipFile_Map(fileName, &data, &size);
+#endif
+
+    if (!data)
+    {
+        SDL_RWops *source = OpenSource(fileName);
+
+        if (!source)
+            return NULL;
+
+        const Sint64 length = SDL_RWsize(source);
+
+        if (length > 0 && (buffer = malloc(length)) && SDL_RWread(source, buffer, 1, length) == (size_t)length)
+        {
+            data = buffer;
+            size = (size_t)length;
+        }
+
+        SDL_RWclose(source);
+
+        if (!data)
+        {
+            free(buffer);
+            return NULL;
+        }
+    }
+
+    // Keyed by the encoded bytes, so a changed asset never matches a stale blob.
+    const Uint64 key = DiskCache_Hash(data, size);
+    SDL_Surface *surface = DiskCache_Load(key);
+
+    if (!surface)
+    {
+        if (size >= 4 && memcmp(data, "qoif", 4) == 0)
+            surface = Qoi_Decode(data, size);
+        else
+            surface = IMG_Load_RW(SDL_RWFromConstMem(data, (int)size), 1);
+
+        if (surface)
+            DiskCache_Store(key, surface);
+    }
+
+    free(buffer);
+
+    return surface;
+}
+
+SDL_RWops *OpenSource(const char *fileName)
+{
+#ifdef USE_DATA_ZIP
+    return DataZipFile_Load_RW(fileName);
+#else
+    return SDL_RWFromFile(fileName, "rb");
+#endif
+}
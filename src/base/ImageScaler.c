@@ -0,0 +1,154 @@
+//-------------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Fábio Pichler
+/*-------------------------------------------------------------------------------
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+-------------------------------------------------------------------------------*/
+
+#include "ImageScaler.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define IMAGE_SCALER_SSE2
+#endif
+
+static void Premultiply(SDL_Surface *surface);
+static void Unpremultiply(SDL_Surface *surface);
+static SDL_Surface *Halve(SDL_Surface *source);
+
+SDL_Surface *ImageScaler_Downscale(SDL_Surface *source, int width, int height)
+{
+    if (width <= 0 || height <= 0 || (width >= source->w && height >= source->h))
+        return NULL;
+
+    SDL_Surface *surface = SDL_ConvertSurfaceFormat(source, SDL_PIXELFORMAT_RGBA32, 0);
+
+    if (!surface)
+        return NULL;
+
+    Premultiply(surface);
+
+    while (surface->w >= width * 2 && surface->h >= height * 2)
+    {
+        SDL_Surface *half = Halve(surface);
+
+        if (!half)
+            break;
+
+        SDL_FreeSurface(surface);
+        surface = half;
+    }
+
+    if (surface->w != width || surface->h != height)
+    {
+        SDL_Surface *scaled = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_RGBA32);
+
+        if (scaled && SDL_SoftStretchLinear(surface, NULL, scaled, NULL) == 0)
+        {
+            SDL_FreeSurface(surface);
+            surface = scaled;
+        }
+        else
+        {
+            SDL_FreeSurface(scaled);
+        }
+    }
+
+    Unpremultiply(surface);
+
+    return surface;
+}
+
+void Premultiply(SDL_Surface *surface)
+{
+    for (int y = 0; y < surface->h; ++y)
+    {
+        Uint8 *p = (Uint8 *)surface->pixels + y * surface->pitch;
+
+        for (int x = 0; x < surface->w; ++x, p += 4)
+        {
+            p[0] = (Uint8)((p[0] * p[3] + 127) / 255);
+            p[1] = (Uint8)((p[1] * p[3] + 127) / 255);
+            p[2] = (Uint8)((p[2] * p[3] + 127) / 255);
+        }
+    }
+}
+
+void Unpremultiply(SDL_Surface *surface)
+{
+    for (int y = 0; y < surface->h; ++y)
+    {
+        Uint8 *p = (Uint8 *)surface->pixels + y * surface->pitch;
+
+        for (int x = 0; x < surface->w; ++x, p += 4)
+        {
+            if (p[3] == 0 || p[3] == 255)
+                continue;
+
+            p[0] = (Uint8)SDL_min(255, (p[0] * 255 + p[3] / 2) / p[3]);
+            p[1] = (Uint8)SDL_min(255, (p[1] * 255 + p[3] / 2) / p[3]);
+            p[2] = (Uint8)SDL_min(255, (p[2] * 255 + p[3] / 2) / p[3]);
+        }
+    }
+}
+
+SDL_Surface *Halve(SDL_Surface *source)
+{
+    SDL_Surface *half = SDL_CreateRGBSurfaceWithFormat(0, source->w / 2, source->h / 2, 32, SDL_PIXELFORMAT_RGBA32);
+
+    if (!half)
+        return NULL;
+
+    for (int y = 0; y < half->h; ++y)
+    {
+        const Uint8 *row0 = (const Uint8 *)source->pixels + (2 * y) * source->pitch;
+        const Uint8 *row1 = row0 + source->pitch;
+        Uint8 *out = (Uint8 *)half->pixels + y * half->pitch;
+        int x = 0;
+
+#ifdef IMAGE_SCALER_SSE2
+        // Four output pixels per step: average the two rows, then the even and odd columns.
+        for (; x + 4 <= half->w; x += 4)
+        {
+            const __m128i a = _mm_avg_epu8(_mm_loadu_si128((const __m128i *)(row0 + x * 8)),
+                                           _mm_loadu_si128((const __m128i *)(row1 + x * 8)));
+            const __m128i b = _mm_avg_epu8(_mm_loadu_si128((const __m128i *)(row0 + x * 8 + 16)),
+                                           _mm_loadu_si128((const __m128i *)(row1 + x * 8 + 16)));
+            const __m128i even = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b),
+                                                                 _MM_SHUFFLE(2, 0, 2, 0)));
+            const __m128i odd = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b),
+                                                                _MM_SHUFFLE(3, 1, 3, 1)));
+
+            _mm_storeu_si128((__m128i *)(out + x * 4), _mm_avg_epu8(even, odd));
+        }
+#endif
+
+        for (; x < half->w; ++x)
+        {
+            const Uint8 *p0 = row0 + x * 8;
+            const Uint8 *p1 = row1 + x * 8;
+
+            for (int c = 0; c < 4; ++c)
+                out[x * 4 + c] = (Uint8)((p0[c] + p0[c + 4] + p1[c] + p1[c + 4] + 2) / 4);
+        }
+    }
+
+    return half;
+}
@@ -0,0 +1,174 @@
+//-------------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Fábio Pichler
+/*-------------------------------------------------------------------------------
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+-------------------------------------------------------------------------------*/
+
+#include "Layer.h"
+#include "Graphics.h"
+#include "RenderBatch.h"
+#include "Damage.h"
+
+#include <stdio.h>
+
+struct Layer
+{
+    Graphics *graphics;
+    SDL_Renderer *renderer;
+    RenderBatch *batch;
+    SDL_Texture *texture;
+    SDL_FRect rect;
+    float scale;
+    Uint32 generation;
+    bool valid;
+    bool direct;
+};
+
+// Bumped when every target texture may have lost its contents.
+static Uint32 generation = 0;
+
+bool Layer_CreateTexture(Layer * const self, float scale);
+
+Layer *Layer_New(Graphics *graphics, SDL_FRect rect)
+{
+    Layer * const self = malloc(sizeof (Layer));
+
+    self->graphics = graphics;
+    self->renderer = Graphics_GetRenderer(graphics);
+    self->batch = Graphics_GetRenderBatch(graphics);
+    self->texture = NULL;
+    self->rect = rect;
+    self->scale = 0.f;
+    self->generation = generation;
+    self->valid = false;
+    self->direct = false;
+
+    return self;
+}
+
+void Layer_Delete(Layer * const self)
+{
+    if (!self)
+        return;
+
+    SDL_DestroyTexture(self->texture);
+    free(self);
+}
+
+void Layer_Invalidate(Layer * const self)
+{
+    self->valid = false;
+    Damage_Invalidate();
+}
+
+void Layer_InvalidateAll(void)
+{
+    generation++;
+    Damage_Invalidate();
+}
+
+bool Layer_Begin(Layer * const self)
+{
+    const float scale = Graphics_GetOutputScale(self->graphics);
+
+    if (self->valid && self->generation == generation && self->scale == scale)
+        return false;
+
+    // Recorded quads may still sample the old texture, submit them before it goes away.
+    RenderBatch_Flush(self->batch);
+
+    if (self->scale != scale || !self->texture)
+        self->direct = !Layer_CreateTexture(self, scale);
+
+    if (self->direct || SDL_SetRenderTarget(self->renderer, self->texture) != 0)
+    {
+        // No target textures: the children draw straight to the screen every frame.
+        self->direct = true;
+        return true;
+    }
+
+    int w, h;
+
+    SDL_QueryTexture(self->texture, NULL, NULL, &w, &h);
+
+    SDL_SetRenderDrawColor(self->renderer, 0, 0, 0, 0);
+    SDL_RenderClear(self->renderer);
+
+    // Children keep drawing in scene coordinates; scale and shift them onto the texture.
+    SDL_RenderSetScale(self->renderer, w / self->rect.w, h / self->rect.h);
+    SDL_RenderSetViewport(self->renderer, &(SDL_Rect) {
+                              (int)-self->rect.x, (int)-self->rect.y,
+                              (int)(self->rect.x + self->rect.w), (int)(self->rect.y + self->rect.h)});
+
+    return true;
+}
+
+void Layer_End(Layer * const self)
+{
+    if (self->direct)
+        return;
+
+    RenderBatch_Flush(self->batch);
+    SDL_SetRenderTarget(self->renderer, NULL);
+
+    self->valid = true;
+    self->generation = generation;
+}
+
+void Layer_Draw(Layer * const self)
+{
+    if (self->direct || !self->valid)
+        return;
+
+    int w, h;
+
+    SDL_QueryTexture(self->texture, NULL, NULL, &w, &h);
+
+    RenderBatch_AddSprite(self->batch, self->texture, &(SDL_Rect) {0, 0, w, h}, &self->rect,
+                          (SDL_Color) {255, 255, 255, 255});
+}
+
+bool Layer_CreateTexture(Layer * const self, float scale)
+{
+    const int w = SDL_max(1, (int)SDL_ceil(self->rect.w * scale));
+    const int h = SDL_max(1, (int)SDL_ceil(self->rect.h * scale));
+
+    SDL_DestroyTexture(self->texture);
+
+    self->scale = scale;
+    self->texture = SDL_CreateTexture(self->renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, w, h);
+
+    if (!self->texture)
+    {
+        printf("Unable to create layer texture! SDL Error: %s\n", SDL_GetError());
+        return false;
+    }
+
+    // Children were blended onto transparent black, so the colors are already premultiplied.
+    const SDL_BlendMode premultiplied = SDL_ComposeCustomBlendMode(
+                SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+                SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+
+    if (SDL_SetTextureBlendMode(self->texture, premultiplied) != 0)
+        SDL_SetTextureBlendMode(self->texture, SDL_BLENDMODE_BLEND);
+
+    return true;
+}
@@ -0,0 +1,62 @@
+//-------------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Fábio Pichler
+/*-------------------------------------------------------------------------------
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+-------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Caches a group of draws covering a fixed logical rect in a target
+// texture at output resolution, then blits it as one quad. Owners call
+// Layer_Invalidate whenever a child changes; the layer is not aware of
+// its children otherwise.
+//
+//     if (Layer_Begin(layer))
+//     {
+//         ...draw children...
+//         Layer_End(layer);
+//     }
+//
+//     Layer_Draw(layer);
+
+typedef struct Layer Layer;
+typedef struct Graphics Graphics;
+
+Layer *Layer_New(Graphics *graphics, SDL_FRect rect);
+void Layer_Delete(Layer * const self);
+
+void Layer_Invalidate(Layer * const self);
+void Layer_InvalidateAll(void);
+
+bool Layer_Begin(Layer * const self);
+void Layer_End(Layer * const self);
+void Layer_Draw(Layer * const self);
+
+#ifdef __cplusplus
+}
+#endif
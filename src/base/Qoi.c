@@ -0,0 +1,177 @@
+//-------------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Fábio Pichler
+/*-------------------------------------------------------------------------------
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+-------------------------------------------------------------------------------*/
+
+#include "Qoi.h"
+
+#include <string.h>
+
+#define QOI_HEADER_SIZE 14
+#define QOI_PADDING_SIZE 8
+#define QOI_MAX_PIXELS 400000000u
+
+#define QOI_OP_INDEX 0x00
+#define QOI_OP_DIFF 0x40
+#define QOI_OP_LUMA 0x80
+#define QOI_OP_RUN 0xc0
+#define QOI_OP_RGB 0xfe
+#define QOI_OP_RGBA 0xff
+#define QOI_MASK_2 0xc0
+
+#define QOI_HASH(p) (((p)[0] * 3 + (p)[1] * 5 + (p)[2] * 7 + (p)[3] * 11) % 64)
+
+static Uint32 ReadU32BE(const unsigned char *p)
+{
+    return ((Uint32)p[0] << 24) | ((Uint32)p[1] << 16) | ((Uint32)p[2] << 8) | (Uint32)p[3];
+}
+
+bool Qoi_IsQoi(SDL_RWops *src)
+{
+    char magic[4];
+
+    if (!src)
+        return false;
+
+    const Sint64 start = SDL_RWtell(src);
+    const bool isQoi = SDL_RWread(src, magic, 1, 4) == 4 && memcmp(magic, "qoif", 4) == 0;
+
+    SDL_RWseek(src, start, RW_SEEK_SET);
+
+    return isQoi;
+}
+
+SDL_Surface *Qoi_Decode(const void *data, size_t size)
+{
+    const unsigned char *bytes = data;
+
+    if (size < QOI_HEADER_SIZE + QOI_PADDING_SIZE || memcmp(bytes, "qoif", 4) != 0)
+    {
+        SDL_SetError("Not a QOI image");
+        return NULL;
+    }
+
+    const Uint32 width = ReadU32BE(bytes + 4);
+    const Uint32 height = ReadU32BE(bytes + 8);
+    const unsigned char channels = bytes[12];
+
+    if (width == 0 || height == 0 || channels < 3 || channels > 4 || height >= QOI_MAX_PIXELS / width)
+    {
+        SDL_SetError("Invalid QOI header");
+        return NULL;
+    }
+
+    SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(0, (int)width, (int)height, 32, SDL_PIXELFORMAT_RGBA32);
+
+    if (!surface)
+        return NULL;
+
+    unsigned char index[64][4];
+    unsigned char px[4] = {0, 0, 0, 255};
+    const size_t end = size - QOI_PADDING_SIZE;
+    size_t p = QOI_HEADER_SIZE;
+    int run = 0;
+
+    memset(index, 0, sizeof (index));
+
+    for (Uint32 y = 0; y < height; ++y)
+    {
+        unsigned char *row = (unsigned char *)surface->pixels + (size_t)y * surface->pitch;
+
+        for (Uint32 x = 0; x < width; ++x)
+        {
+            if (run > 0)
+            {
+                run--;
+            }
+            else if (p < end)
+            {
+                const unsigned char b1 = bytes[p++];
+
+                if (b1 == QOI_OP_RGB)
+                {
+                    px[0] = bytes[p++];
+                    px[1] = bytes[p++];
+                    px[2] = bytes[p++];
+                }
+                else if (b1 == QOI_OP_RGBA)
+                {
+                    px[0] = bytes[p++];
+                    px[1] = bytes[p++];
+                    px[2] = bytes[p++];
+                    px[3] = bytes[p++];
+                }
+                else if ((b1 & QOI_MASK_2) == QOI_OP_INDEX)
+                {
+                    memcpy(px, index[b1], 4);
+                }
+                else if ((b1 & QOI_MASK_2) == QOI_OP_DIFF)
+                {
+                    px[0] += ((b1 >> 4) & 0x03) - 2;
+                    px[1] += ((b1 >> 2) & 0x03) - 2;
+                    px[2] += (b1 & 0x03) - 2;
+                }
+                else if ((b1 & QOI_MASK_2) == QOI_OP_LUMA)
+                {
+                    const unsigned char b2 = bytes[p++];
+                    const int vg = (b1 & 0x3f) - 32;
+
+                    px[0] += vg - 8 + ((b2 >> 4) & 0x0f);
+                    px[1] += vg;
+                    px[2] += vg - 8 + (b2 & 0x0f);
+                }
+                else
+                {
+                    run = b1 & 0x3f;
+                }
+
+                memcpy(index[QOI_HASH(px)], px, 4);
+            }
+
+            memcpy(row + x * 4, px, 4);
+        }
+    }
+
+    return surface;
+}
+
+SDL_Surface *Qoi_Load_RW(SDL_RWops *src, int freesrc)
+{
+    if (!src)
+        return NULL;
+
+    SDL_Surface *surface = NULL;
+    const Sint64 size = SDL_RWsize(src) - SDL_RWtell(src);
+    void *data = size > 0 ? malloc((size_t)size) : NULL;
+
+    if (data && SDL_RWread(src, data, 1, (size_t)size) == (size_t)size)
+        surface = Qoi_Decode(data, (size_t)size);
+    else
+        SDL_SetError("Unable to read QOI data");
+
+    free(data);
+
+    if (freesrc)
+        SDL_RWclose(src);
+
+    return surface;
+}
@@ -0,0 +1,122 @@
+//-------------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Fábio Pichler
+/*-------------------------------------------------------------------------------
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+-------------------------------------------------------------------------------*/
+
+#include "RectPacker.h"
+
+#include <stdlib.h>
+
+typedef struct Shelf
+{
+    int y;
+    int height;
+    int x;
+} Shelf;
+
+struct RectPacker
+{
+    int width;
+    int height;
+    int padding;
+
+    Shelf *shelves;
+    int shelfCount;
+    int shelfCapacity;
+};
+
+RectPacker *RectPacker_New(int width, int height, int padding)
+{
+    RectPacker * const self = malloc(sizeof (RectPacker));
+
+    self->width = width;
+    self->height = height;
+    self->padding = padding;
+
+    self->shelves = NULL;
+    self->shelfCount = 0;
+    self->shelfCapacity = 0;
+
+    return self;
+}
+
+void RectPacker_Delete(RectPacker * const self)
+{
+    if (!self)
+        return;
+
+    free(self->shelves);
+    free(self);
+}
+
+void RectPacker_Resize(RectPacker * const self, int width, int height)
+{
+    // Shelves only grow to the right and downwards, so packed rects stay valid.
+    if (width > self->width)
+        self->width = width;
+
+    if (height > self->height)
+        self->height = height;
+}
+
+bool RectPacker_Pack(RectPacker * const self, int w, int h, SDL_Rect *rect)
+{
+    const int pw = w + self->padding;
+    const int ph = h + self->padding;
+
+    Shelf *best = NULL;
+
+    for (int i = 0; i < self->shelfCount; ++i)
+    {
+        Shelf *shelf = &self->shelves[i];
+
+        if (shelf->height >= ph && shelf->x + pw <= self->width)
+        {
+            if (!best || shelf->height < best->height)
+                best = shelf;
+        }
+    }
+
+    if (!best)
+    {
+        const int y = self->shelfCount > 0
+                ? self->shelves[self->shelfCount - 1].y + self->shelves[self->shelfCount - 1].height
+                : self->padding;
+
+        if (y + ph > self->height || self->padding + pw > self->width)
+            return false;
+
+        if (self->shelfCount == self->shelfCapacity)
+        {
+            self->shelfCapacity = self->shelfCapacity ? self->shelfCapacity * 2 : 8;
+            self->shelves = realloc(self->shelves, sizeof (Shelf) * self->shelfCapacity);
+        }
+
+        best = &self->shelves[self->shelfCount++];
+        *best = (Shelf) {.y = y, .height = ph, .x = self->padding};
+    }
+
+    *rect = (SDL_Rect) {best->x, best->y, w, h};
+    best->x += pw;
+
+    return true;
+}
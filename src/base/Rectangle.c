@@ -24,22 +24,36 @@ SOFTWARE.
 
 #include "Rectangle.h"
 #include "Box.h"
+#include "Damage.h"
+#include "Graphics.h"
+#include "RenderBatch.h"
+#include "DisplayList.h"
 
 struct Rectangle
 {
-    SDL_Renderer *renderer;
+    RenderBatch *batch;
     Box *box;
     SDL_Color color;
+
+    DisplayList *displayList;
+    int displayNode;
 };
 
-Rectangle *Rectangle_New(SDL_Renderer *renderer, float width, float height)
+void Rectangle_BoxOnUpdateEvent(Box * const box, void *userdata);
+
+Rectangle *Rectangle_New(Graphics *graphics, float width, float height)
 {
     Rectangle * const self = malloc(sizeof (Rectangle));
 
-    self->renderer = renderer;
+    self->batch = Graphics_GetRenderBatch(graphics);
     self->box = Box_New(0.f, 0.f, width, height);
     self->color = (SDL_Color) {0, 0, 0, 0};
 
+    self->displayList = NULL;
+    self->displayNode = -1;
+
+    Box_SetOnPressEvent(self->box, Rectangle_BoxOnUpdateEvent, self);
+
     return self;
 }
 
@@ -54,29 +68,36 @@ void Rectangle_Delete(Rectangle * const self)
 
 void Rectangle_Draw(Rectangle * const self)
 {
-    SDL_SetRenderDrawColor(self->renderer, self->color.r, self->color.g, self->color.b, self->color.a);
-    SDL_RenderFillRectF(self->renderer, Box_Rect(self->box));
+    RenderBatch_AddRect(self->batch, Box_Rect(self->box), self->color);
+}
+
+int Rectangle_AddToDisplayList(Rectangle * const self, DisplayList *displayList)
+{
+    self->displayList = displayList;
+    self->displayNode = DisplayList_AddRect(displayList, Box_Rect(self->box), self->color);
+
+    return self->displayNode;
 }
 
 void Rectangle_SetColor(Rectangle * const self, SDL_Color color)
 {
+    if (color.r != self->color.r || color.g != self->color.g || color.b != self->color.b || color.a != self->color.a)
+        Damage_Invalidate();
+
     self->color = color;
+
+    if (self->displayList)
+        DisplayList_SetColor(self->displayList, self->displayNode, color);
 }
 
 void Rectangle_SetColorRGB(Rectangle * const self, uint8_t r, uint8_t g, uint8_t b)
 {
-    self->color.r = r;
-    self->color.g = g;
-    self->color.b = b;
-    self->color.a = 255;
+    Rectangle_SetColor(self, (SDL_Color) {r, g, b, 255});
 }
 
 void Rectangle_SetColorRGBA(Rectangle * const self, uint8_t r, uint8_t g, uint8_t b, uint8_t a)
 {
-    self->color.r = r;
-    self->color.g = g;
-    self->color.b = b;
-    self->color.a = a;
+    Rectangle_SetColor(self, (SDL_Color) {r, g, b, a});
 }
 
 SDL_Color Rectangle_Color(Rectangle * const self)
@@ -88,3 +109,11 @@ Box *Rectangle_Box(Rectangle * const self)
 {
     return self->box;
 }
+
+void Rectangle_BoxOnUpdateEvent(Box * const box, void *userdata)
+{
+    Rectangle * const self = userdata;
+
+    if (self->displayList)
+        DisplayList_SetRect(self->displayList, self->displayNode, Box_Rect(box));
+}
@@ -31,12 +31,15 @@ extern "C" {
 #endif
 
 typedef struct Box Box;
+typedef struct DisplayList DisplayList;
+typedef struct Graphics Graphics;
 
 typedef struct Rectangle Rectangle;
 
-Rectangle *Rectangle_New(SDL_Renderer *renderer, float width, float height);
+Rectangle *Rectangle_New(Graphics *graphics, float width, float height);
 void Rectangle_Delete(Rectangle * const self);
 void Rectangle_Draw(Rectangle * const self);
+int Rectangle_AddToDisplayList(Rectangle * const self, DisplayList *displayList);
 
 void Rectangle_SetColor(Rectangle * const self, SDL_Color color);
 void Rectangle_SetColorRGB(Rectangle * const self, uint8_t r, uint8_t g, uint8_t b);
@@ -0,0 +1,362 @@
+//-------------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Fábio Pichler
+/*-------------------------------------------------------------------------------
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+-------------------------------------------------------------------------------*/
+
+#include "RenderBatch.h"
+
+typedef struct BatchCommand
+{
+    int layer;
+    SDL_Texture *texture;
+    SDL_BlendMode blendMode;
+    int sequence;
+} BatchCommand;
+
+struct RenderBatch
+{
+    SDL_Renderer *renderer;
+    int layer;
+
+    SDL_Texture *lastTexture;
+    SDL_BlendMode lastBlendMode;
+    float textureW;
+    float textureH;
+
+    SDL_Texture *solidTexture;
+    SDL_FPoint solidTexel;
+
+    BatchCommand *commands;
+    SDL_Vertex *vertices;
+    SDL_Vertex *sorted;
+    int *indices;
+    int quadCount;
+    int quadCapacity;
+
+    int drawCalls;
+    int savedStateChanges;
+    int frameDrawCalls;
+    int frameSavedStateChanges;
+};
+
+void RenderBatch_Record(RenderBatch * const self, SDL_Texture *texture, SDL_BlendMode blendMode,
+                        const SDL_FRect *rect, SDL_Color color, float u0, float v0, float u1, float v1);
+void RenderBatch_Submit(RenderBatch * const self, int first, int count);
+int RenderBatch_CompareCommands(const void *a, const void *b);
+void RenderBatch_ReserveQuads(RenderBatch * const self, int count);
+
+RenderBatch *RenderBatch_New(SDL_Renderer *renderer)
+{
+    RenderBatch * const self = malloc(sizeof (RenderBatch));
+
+    self->renderer = renderer;
+    self->layer = 0;
+
+    self->lastTexture = NULL;
+    self->lastBlendMode = SDL_BLENDMODE_BLEND;
+    self->textureW = 1.f;
+    self->textureH = 1.f;
+
+    self->solidTexture = NULL;
+    self->solidTexel = (SDL_FPoint) {0.f, 0.f};
+
+    self->commands = NULL;
+    self->vertices = NULL;
+    self->sorted = NULL;
+    self->indices = NULL;
+    self->quadCount = 0;
+    self->quadCapacity = 0;
+
+    self->drawCalls = 0;
+    self->savedStateChanges = 0;
+    self->frameDrawCalls = 0;
+    self->frameSavedStateChanges = 0;
+
+    return self;
+}
+
+void RenderBatch_Delete(RenderBatch * const self)
+{
+    if (!self)
+        return;
+
+    free(self->commands);
+    free(self->vertices);
+    free(self->sorted);
+    free(self->indices);
+    free(self);
+}
+
+void RenderBatch_SetLayer(RenderBatch * const self, int layer)
+{
+    if (self)
+        self->layer = layer;
+}
+
+int RenderBatch_GetLayer(RenderBatch * const self)
+{
+    return self ? self->layer : 0;
+}
+
+void RenderBatch_AddRect(RenderBatch * const self, const SDL_FRect *rect, SDL_Color color)
+{
+    SDL_BlendMode blendMode;
+
+    // Opaque quads sample the atlas white texel so they can share its runs.
+    if (self->solidTexture && color.a == 255
+            && SDL_GetTextureBlendMode(self->solidTexture, &blendMode) == 0)
+    {
+        const SDL_FPoint texel = self->solidTexel;
+
+        RenderBatch_Record(self, self->solidTexture, blendMode, rect, color,
+                           texel.x, texel.y, texel.x, texel.y);
+        return;
+    }
+
+    // Untextured geometry blends with the draw blend mode, same as SDL_RenderFillRectF.
+    if (SDL_GetRenderDrawBlendMode(self->renderer, &blendMode) != 0)
+        blendMode = SDL_BLENDMODE_NONE;
+
+    RenderBatch_Record(self, NULL, blendMode, rect, color, 0.f, 0.f, 0.f, 0.f);
+}
+
+void RenderBatch_AddSprite(RenderBatch * const self, SDL_Texture *texture, const SDL_Rect *srcrect,
+                           const SDL_FRect *dstrect, SDL_Color color)
+{
+    int w, h;
+
+    if (texture != self->lastTexture)
+    {
+        self->lastTexture = texture;
+        self->textureW = 1.f;
+        self->textureH = 1.f;
+
+        if (SDL_QueryTexture(texture, NULL, NULL, &w, &h) == 0)
+        {
+            self->textureW = (float)w;
+            self->textureH = (float)h;
+        }
+    }
+
+    // The blend mode is read every time, the same texture may be drawn with different modes.
+    if (SDL_GetTextureBlendMode(texture, &self->lastBlendMode) != 0)
+        self->lastBlendMode = SDL_BLENDMODE_BLEND;
+
+    const float u0 = srcrect->x / self->textureW;
+    const float v0 = srcrect->y / self->textureH;
+    const float u1 = (srcrect->x + srcrect->w) / self->textureW;
+    const float v1 = (srcrect->y + srcrect->h) / self->textureH;
+
+    RenderBatch_Record(self, texture, self->lastBlendMode, dstrect, color, u0, v0, u1, v1);
+}
+
+void RenderBatch_SetSolidTexel(RenderBatch * const self, SDL_Texture *texture, SDL_Rect rect)
+{
+    int w, h;
+
+    RenderBatch_Flush(self);
+
+    if (!texture || SDL_QueryTexture(texture, NULL, NULL, &w, &h) != 0)
+    {
+        self->solidTexture = NULL;
+        return;
+    }
+
+    self->solidTexture = texture;
+    self->solidTexel.x = (rect.x + rect.w * 0.5f) / w;
+    self->solidTexel.y = (rect.y + rect.h * 0.5f) / h;
+}
+
+void RenderBatch_Flush(RenderBatch * const self)
+{
+    if (!self)
+        return;
+
+    // Forget the cached texture, it may be destroyed before the next quad arrives.
+    self->lastTexture = NULL;
+
+    if (self->quadCount == 0)
+        return;
+
+    int unsortedRuns = 1;
+
+    for (int i = 1; i < self->quadCount; ++i)
+    {
+        const BatchCommand *a = &self->commands[i - 1];
+        const BatchCommand *b = &self->commands[i];
+
+        if (a->texture != b->texture || a->blendMode != b->blendMode)
+            unsortedRuns++;
+    }
+
+    // Ties fall back to the record sequence, which keeps the sort stable.
+    SDL_qsort(self->commands, self->quadCount, sizeof (BatchCommand), RenderBatch_CompareCommands);
+
+    for (int i = 0; i < self->quadCount; ++i)
+        SDL_memcpy(&self->sorted[i * 4], &self->vertices[self->commands[i].sequence * 4],
+                   sizeof (SDL_Vertex) * 4);
+
+    int runs = 0;
+    int first = 0;
+
+    for (int i = 1; i <= self->quadCount; ++i)
+    {
+        if (i < self->quadCount
+                && self->commands[i].texture == self->commands[first].texture
+                && self->commands[i].blendMode == self->commands[first].blendMode)
+            continue;
+
+        RenderBatch_Submit(self, first, i - first);
+        first = i;
+        runs++;
+    }
+
+    self->drawCalls += runs;
+    self->savedStateChanges += SDL_max(0, unsortedRuns - runs);
+    self->quadCount = 0;
+}
+
+void RenderBatch_EndFrame(RenderBatch * const self)
+{
+    if (!self)
+        return;
+
+    RenderBatch_Flush(self);
+
+    self->frameDrawCalls = self->drawCalls;
+    self->frameSavedStateChanges = self->savedStateChanges;
+    self->drawCalls = 0;
+    self->savedStateChanges = 0;
+    self->layer = 0;
+}
+
+void RenderBatch_GetFrameStats(RenderBatch * const self, int *drawCalls, int *savedStateChanges)
+{
+    if (drawCalls)
+        *drawCalls = self->frameDrawCalls;
+
+    if (savedStateChanges)
+        *savedStateChanges = self->frameSavedStateChanges;
+}
+
+void RenderBatch_Record(RenderBatch * const self, SDL_Texture *texture, SDL_BlendMode blendMode,
+                        const SDL_FRect *rect, SDL_Color color, float u0, float v0, float u1, float v1)
+{
+    RenderBatch_ReserveQuads(self, self->quadCount + 1);
+
+    const float x0 = rect->x;
+    const float y0 = rect->y;
+    const float x1 = rect->x + rect->w;
+    const float y1 = rect->y + rect->h;
+
+    SDL_Vertex *vertex = &self->vertices[self->quadCount * 4];
+
+    vertex[0] = (SDL_Vertex) {{x0, y0}, color, {u0, v0}};
+    vertex[1] = (SDL_Vertex) {{x1, y0}, color, {u1, v0}};
+    vertex[2] = (SDL_Vertex) {{x1, y1}, color, {u1, v1}};
+    vertex[3] = (SDL_Vertex) {{x0, y1}, color, {u0, v1}};
+
+    BatchCommand *command = &self->commands[self->quadCount];
+
+    command->layer = self->layer;
+    command->texture = texture;
+    command->blendMode = blendMode;
+    command->sequence = self->quadCount;
+
+    self->quadCount++;
+}
+
+void RenderBatch_Submit(RenderBatch * const self, int first, int count)
+{
+    const BatchCommand *command = &self->commands[first];
+    SDL_BlendMode previous = command->blendMode;
+
+    // Apply the recorded blend mode and put the owner's back afterwards.
+    if (!command->texture)
+        SDL_GetRenderDrawBlendMode(self->renderer, &previous);
+    else
+        SDL_GetTextureBlendMode(command->texture, &previous);
+
+    if (previous != command->blendMode)
+    {
+        if (!command->texture)
+            SDL_SetRenderDrawBlendMode(self->renderer, command->blendMode);
+        else
+            SDL_SetTextureBlendMode(command->texture, command->blendMode);
+    }
+
+    SDL_RenderGeometry(self->renderer, command->texture, &self->sorted[first * 4], count * 4,
+                       self->indices, count * 6);
+
+    if (previous != command->blendMode)
+    {
+        if (!command->texture)
+            SDL_SetRenderDrawBlendMode(self->renderer, previous);
+        else
+            SDL_SetTextureBlendMode(command->texture, previous);
+    }
+}
+
+int RenderBatch_CompareCommands(const void *a, const void *b)
+{
+    const BatchCommand *x = a;
+    const BatchCommand *y = b;
+
+    if (x->layer != y->layer)
+        return x->layer < y->layer ? -1 : 1;
+
+    if (x->texture != y->texture)
+        return (uintptr_t)x->texture < (uintptr_t)y->texture ? -1 : 1;
+
+    if (x->blendMode != y->blendMode)
+        return x->blendMode < y->blendMode ? -1 : 1;
+
+    return x->sequence < y->sequence ? -1 : x->sequence > y->sequence;
+}
+
+void RenderBatch_ReserveQuads(RenderBatch * const self, int count)
+{
+    if (count <= self->quadCapacity)
+        return;
+
+    count = SDL_max(count, self->quadCapacity * 2);
+
+    self->commands = realloc(self->commands, sizeof (BatchCommand) * count);
+    self->vertices = realloc(self->vertices, sizeof (SDL_Vertex) * 4 * count);
+    self->sorted = realloc(self->sorted, sizeof (SDL_Vertex) * 4 * count);
+    self->indices = realloc(self->indices, sizeof (int) * 6 * count);
+
+    for (int i = self->quadCapacity; i < count; ++i)
+    {
+        int *index = &self->indices[i * 6];
+        const int vertex = i * 4;
+
+        index[0] = vertex;
+        index[1] = vertex + 1;
+        index[2] = vertex + 2;
+        index[3] = vertex;
+        index[4] = vertex + 2;
+        index[5] = vertex + 3;
+    }
+
+    self->quadCapacity = count;
+}
@@ -0,0 +1,62 @@
+//-------------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Fábio Pichler
+/*-------------------------------------------------------------------------------
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+-------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <SDL2/SDL.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Deferred quad buffer for one renderer. Quads are recorded with the
+// current layer plus their texture and blend mode; RenderBatch_Flush
+// stable-sorts them by (layer, texture, blend mode) and submits each run
+// of equal state with one SDL_RenderGeometry call. Quads within a layer
+// are ordered by texture, not by submission, so anything drawn on top of
+// another quad must go on a higher layer than what it covers.
+// Opaque solid quads sample the white texel registered with
+// RenderBatch_SetSolidTexel, so they share runs with that texture.
+// Anything that draws to the renderer outside the batch must call
+// RenderBatch_Flush first to keep draw order.
+
+typedef struct RenderBatch RenderBatch;
+
+RenderBatch *RenderBatch_New(SDL_Renderer *renderer);
+void RenderBatch_Delete(RenderBatch * const self);
+
+void RenderBatch_SetLayer(RenderBatch * const self, int layer);
+int RenderBatch_GetLayer(RenderBatch * const self);
+void RenderBatch_AddRect(RenderBatch * const self, const SDL_FRect *rect, SDL_Color color);
+void RenderBatch_AddSprite(RenderBatch * const self, SDL_Texture *texture, const SDL_Rect *srcrect,
+                           const SDL_FRect *dstrect, SDL_Color color);
+void RenderBatch_SetSolidTexel(RenderBatch * const self, SDL_Texture *texture, SDL_Rect rect);
+void RenderBatch_Flush(RenderBatch * const self);
+
+void RenderBatch_EndFrame(RenderBatch * const self);
+void RenderBatch_GetFrameStats(RenderBatch * const self, int *drawCalls, int *savedStateChanges);
+
+#ifdef __cplusplus
+}
+#endif
@@ -25,13 +25,40 @@ SOFTWARE.
 #include "SceneManager.h"
 #include "Window.h"
 #include "Graphics.h"
+#include "AssetLoader.h"
+#include "TextureCache.h"
+#include "RenderBatch.h"
+#include "Damage.h"
+#include "Layer.h"
 #include "private/Timer.h"
 
+#include <stdio.h>
+
 #ifdef __EMSCRIPTEN__
   #include <emscripten.h>
   #include <emscripten/html5.h>
 #endif
 
+// Time per frame spent turning decoded images into textures.
+#define ASSET_UPLOAD_BUDGET_MS 4
+
+// How often an idle loop still wakes up while images decode in the background.
+#define IDLE_ASSET_POLL_MS 8
+
+#define DEFAULT_TARGET_FPS 60
+
+// Adaptive pacing drops to this rate after a second without input.
+#define ADAPTIVE_IDLE_FPS 20
+#define ADAPTIVE_IDLE_MS 1000
+
+// The frame limiter sleeps until this close to the deadline, then spins.
+#define PACING_SPIN_MS 2
+
+#define FRAME_STATS_WINDOW 120
+
+// Simulation steps run per loop before the rest of a stall is dropped.
+#define MAX_CATCH_UP_STEPS 5
+
 struct SceneManager
 {
     SDL_Event event;
@@ -49,6 +76,28 @@ struct SceneManager
     } scene;
 
     Timer *timer;
+
+    double fixedStep;
+    double accumulator;
+    double alpha;
+
+    SceneManager_FramePacing pacing;
+    int targetFps;
+    Uint64 frameStart;
+    Uint64 lastInput;
+    Uint64 lastFrame;
+    bool waitedIdle;
+
+    struct
+    {
+        int count;
+        double sum;
+        double sumSquares;
+        double min;
+        double max;
+    } samples;
+
+    SceneManager_FrameStats frameStats;
 };
 
 static void OverrideSceneFunctions(SceneManager_CurrentScene *func)
@@ -65,6 +114,9 @@ static void OverrideSceneFunctions(SceneManager_CurrentScene *func)
 void SceneManager_InitScene(SceneManager * const self);
 void SceneManager_Update(SceneManager * const self);
 void SceneManager_Draw(SceneManager * const self);
+void SceneManager_WaitIdle(SceneManager * const self);
+void SceneManager_PaceFrame(SceneManager * const self);
+void SceneManager_AddFrameSample(SceneManager * const self, double ms);
 bool SceneManager_MainLoop(SceneManager * const self);
 
 SceneManager *SceneManager_New(Window *window, Graphics *graphics)
@@ -82,6 +134,19 @@ SceneManager *SceneManager_New(Window *window, Graphics *graphics)
 
     self->timer = Timer_New();
 
+    self->fixedStep = 0.0;
+    self->accumulator = 0.0;
+    self->alpha = 1.0;
+
+    self->frameStart = 0;
+    self->lastInput = self->lastPerformanceCounter;
+    self->lastFrame = 0;
+    self->waitedIdle = false;
+    self->samples.count = 0;
+    self->frameStats = (SceneManager_FrameStats) {0, 0.0, 0.0, 0.0, 0.0};
+
+    SceneManager_SetFramePacing(self, FramePacing_VSync, DEFAULT_TARGET_FPS);
+
     return self;
 }
 
@@ -90,11 +155,12 @@ void SceneManager_Delete(SceneManager * const self)
     if (!self)
         return;
 
-    Timer_Delete(self->timer);
-
+    // Scenes may still cancel their timers while being deleted.
     if (self->scene.func.onDelete)
         self->scene.func.onDelete(self->scene.self);
 
+    Timer_Delete(self->timer);
+
     free(self);
 }
 
@@ -114,12 +180,32 @@ void SceneManager_InitScene(SceneManager * const self)
         OverrideSceneFunctions(&self->newScene);
 
         self->scene.self = self->scene.func.onNew(self);
+
+        Damage_Invalidate();
     }
 }
 
-void SceneManager_AddTimer(SceneManager * const self, Uint32 interval, SceneManager_TimerCallback callback, void *userdata)
+SceneManager_TimerHandle SceneManager_AddTimer(SceneManager * const self, Uint32 interval,
+                                               SceneManager_TimerCallback callback, void *userdata)
+{
+    return Timer_Add(self->timer, interval, callback, userdata);
+}
+
+SceneManager_TimerHandle SceneManager_AddTimerPayload(SceneManager * const self, Uint32 interval,
+                                                      SceneManager_TimerCallback callback,
+                                                      const void *payload, size_t size)
+{
+    return Timer_AddPayload(self->timer, interval, callback, payload, size);
+}
+
+bool SceneManager_CancelTimer(SceneManager * const self, SceneManager_TimerHandle handle)
+{
+    return Timer_Cancel(self->timer, handle);
+}
+
+bool SceneManager_RescheduleTimer(SceneManager * const self, SceneManager_TimerHandle handle, Uint32 interval)
 {
-    Timer_Add(self->timer, interval, callback, userdata);
+    return Timer_Reschedule(self->timer, handle, interval);
 }
 
 void SceneManager_ClearTimers(SceneManager * const self)
@@ -136,16 +222,41 @@ bool SceneManager_MainLoop(SceneManager * const self)
         if (self->event.type == SDL_QUIT || self->event.key.keysym.sym == SDLK_AC_BACK)
             return false;
 
+        if (self->event.type == SDL_WINDOWEVENT && self->event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED)
+            Graphics_UpdateOutputScale(self->graphics);
+
+        // Exposed, resized or lost render targets: the back buffer has to be redrawn.
+        if (self->event.type == SDL_WINDOWEVENT)
+            Damage_Invalidate();
+
+        if (self->event.type == SDL_RENDER_TARGETS_RESET || self->event.type == SDL_RENDER_DEVICE_RESET)
+            Layer_InvalidateAll();
+
+        if (self->event.type != SDL_WINDOWEVENT)
+            self->lastInput = SDL_GetPerformanceCounter();
+
         if (self->scene.func.onProcessEvent)
             self->scene.func.onProcessEvent(self->scene.self, &self->event);
-
-        Timer_ProcessEvent(self->timer, self, &self->event);
     }
 
     Timer_Update(self->timer, self);
+    AssetLoader_Update(Graphics_GetAssetLoader(self->graphics), ASSET_UPLOAD_BUDGET_MS);
 
     SceneManager_Update(self);
-    SceneManager_Draw(self);
+
+    if (Damage_IsPending())
+    {
+        // Only drawn frames count towards eviction, so an idle screen keeps its textures.
+        TextureCache_NextFrame(Graphics_GetTextureCache(self->graphics));
+        SceneManager_Draw(self);
+        SceneManager_PaceFrame(self);
+    }
+#ifndef __EMSCRIPTEN__
+    else
+    {
+        SceneManager_WaitIdle(self);
+    }
+#endif
 
     return true;
 }
@@ -182,21 +293,194 @@ void SceneManager_Update(SceneManager * const self)
     double deltaTime = (double)(now - self->lastPerformanceCounter) / (double)SDL_GetPerformanceFrequency();
     self->lastPerformanceCounter = now;
 
-    if (self->scene.func.onUpdate)
+    if (!self->scene.func.onUpdate)
+        return;
+
+    if (self->fixedStep <= 0.0)
+    {
         self->scene.func.onUpdate(self->scene.self, deltaTime);
+        return;
+    }
+
+    self->accumulator += deltaTime;
+
+    for (int steps = 0; self->accumulator >= self->fixedStep; ++steps)
+    {
+        // A long stall is dropped rather than replayed, keeping only the fraction for alpha.
+        if (steps == MAX_CATCH_UP_STEPS)
+        {
+            self->accumulator -= self->fixedStep * (int)(self->accumulator / self->fixedStep);
+            break;
+        }
+
+        self->scene.func.onUpdate(self->scene.self, self->fixedStep);
+        self->accumulator -= self->fixedStep;
+    }
+
+    self->alpha = self->accumulator / self->fixedStep;
 }
 
 void SceneManager_Draw(SceneManager * const self)
 {
+    // Cleared first, so changes made while drawing schedule one more frame.
+    Damage_Clear();
+
     SDL_SetRenderDrawColor(self->renderer, 0, 0, 0, 255);
     SDL_RenderClear(self->renderer);
 
     if (self->scene.func.onDraw)
-        self->scene.func.onDraw(self->scene.self);
+        self->scene.func.onDraw(self->scene.self, self->alpha);
+
+    RenderBatch *batch = Graphics_GetRenderBatch(self->graphics);
+
+    RenderBatch_EndFrame(batch);
+
+#ifdef RENDER_STATS
+    int drawCalls, savedStateChanges;
+
+    RenderBatch_GetFrameStats(batch, &drawCalls, &savedStateChanges);
+    printf("Frame: %d draw calls, %d state changes saved\n", drawCalls, savedStateChanges);
+#endif
 
     SDL_RenderPresent(self->renderer);
 }
 
+void SceneManager_WaitIdle(SceneManager * const self)
+{
+    Sint32 timeout = Timer_GetTimeout(self->timer);
+
+    if (AssetLoader_IsBusy(Graphics_GetAssetLoader(self->graphics)))
+        timeout = timeout < 0 ? IDLE_ASSET_POLL_MS : SDL_min(timeout, IDLE_ASSET_POLL_MS);
+
+    self->waitedIdle = true;
+
+    // Nothing animates and nothing is due: block until input or the next timer.
+    // The event stays queued for the next SDL_PollEvent.
+    if (timeout < 0)
+        SDL_WaitEvent(NULL);
+
+    else if (timeout > 0)
+        SDL_WaitEventTimeout(NULL, timeout);
+}
+
+void SceneManager_SetFixedTimestep(SceneManager * const self, double step)
+{
+    self->fixedStep = step;
+    self->accumulator = 0.0;
+    self->alpha = 1.0;
+}
+
+void SceneManager_SetFramePacing(SceneManager * const self, SceneManager_FramePacing pacing, int targetFps)
+{
+    self->targetFps = targetFps > 0 ? targetFps : DEFAULT_TARGET_FPS;
+
+    // Without vsync support the display rate is the next best cap.
+    if (!Graphics_SetVSync(self->graphics, pacing == FramePacing_VSync) && pacing == FramePacing_VSync)
+    {
+        SDL_DisplayMode mode;
+
+        pacing = FramePacing_Fixed;
+
+        if (SDL_GetWindowDisplayMode(Window_GetSDLWindow(self->window), &mode) == 0 && mode.refresh_rate > 0)
+            self->targetFps = mode.refresh_rate;
+    }
+
+    self->pacing = pacing;
+    self->frameStart = 0;
+    self->lastFrame = 0;
+    self->samples.count = 0;
+}
+
+SceneManager_FramePacing SceneManager_GetFramePacing(SceneManager * const self)
+{
+    return self->pacing;
+}
+
+SceneManager_FrameStats SceneManager_GetFrameStats(SceneManager * const self)
+{
+    return self->frameStats;
+}
+
+void SceneManager_PaceFrame(SceneManager * const self)
+{
+    const Uint64 frequency = SDL_GetPerformanceFrequency();
+    Uint64 now = SDL_GetPerformanceCounter();
+    int fps = 0;
+
+    if (self->pacing == FramePacing_Fixed)
+        fps = self->targetFps;
+
+    else if (self->pacing == FramePacing_Adaptive)
+        fps = (now - self->lastInput) * 1000 / frequency > ADAPTIVE_IDLE_MS ? ADAPTIVE_IDLE_FPS : self->targetFps;
+
+#ifndef __EMSCRIPTEN__
+    if (fps > 0)
+    {
+        const Uint64 period = frequency / fps;
+        const Uint64 spin = frequency * PACING_SPIN_MS / 1000;
+        Uint64 deadline = self->frameStart + period;
+
+        // After an idle wait or a long stall, start a new cadence instead of catching up.
+        if (now > deadline + period)
+            deadline = now;
+
+        // SDL_Delay alone oversleeps by up to a scheduler tick; the last stretch is spun.
+        if (deadline > now + spin)
+            SDL_Delay((Uint32)((deadline - now - spin) * 1000 / frequency));
+
+        while ((now = SDL_GetPerformanceCounter()) < deadline)
+            ;
+
+        self->frameStart = deadline;
+    }
+#endif
+
+    // Gaps spent blocked in SceneManager_WaitIdle are not frame times.
+    if (self->lastFrame && !self->waitedIdle)
+        SceneManager_AddFrameSample(self, (double)(now - self->lastFrame) * 1000.0 / frequency);
+
+    self->lastFrame = now;
+    self->waitedIdle = false;
+}
+
+void SceneManager_AddFrameSample(SceneManager * const self, double ms)
+{
+    if (self->samples.count == 0)
+    {
+        self->samples.sum = 0.0;
+        self->samples.sumSquares = 0.0;
+        self->samples.min = ms;
+        self->samples.max = ms;
+    }
+
+    self->samples.count++;
+    self->samples.sum += ms;
+    self->samples.sumSquares += ms * ms;
+    self->samples.min = SDL_min(self->samples.min, ms);
+    self->samples.max = SDL_max(self->samples.max, ms);
+
+    if (self->samples.count < FRAME_STATS_WINDOW)
+        return;
+
+    const double average = self->samples.sum / self->samples.count;
+    const double variance = self->samples.sumSquares / self->samples.count - average * average;
+
+    self->frameStats = (SceneManager_FrameStats) {
+            .frames = self->samples.count,
+            .averageMs = average,
+            .jitterMs = SDL_sqrt(SDL_max(variance, 0.0)),
+            .minMs = self->samples.min,
+            .maxMs = self->samples.max,
+        };
+
+    self->samples.count = 0;
+
+#ifdef RENDER_STATS
+    printf("Frame time: %.2f ms average, %.2f ms jitter, %.2f-%.2f ms\n",
+           average, self->frameStats.jitterMs, self->frameStats.minMs, self->frameStats.maxMs);
+#endif
+}
+
 Window *SceneManager_Window(SceneManager * const self)
 {
     return self->window;
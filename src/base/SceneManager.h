@@ -40,9 +40,36 @@ typedef void *(*SceneManager_NewCallback)(SceneManager *sceneManager);
 typedef void (*SceneManager_DeleteCallback)(void * const self);
 typedef void (*SceneManager_ProcessEventCallback)(void * const self, const SDL_Event *event);
 typedef void (*SceneManager_UpdateCallback)(void * const self, double deltaTime);
-typedef void (*SceneManager_DrawCallback)(void * const self);
+typedef void (*SceneManager_DrawCallback)(void * const self, double alpha);
 typedef void (*SceneManager_TimerCallback)(void * const manager, void *userdata);
 
+// Identifies a pending timer; stays safe to cancel after the timer fired.
+typedef Uint64 SceneManager_TimerHandle;
+
+// Largest payload SceneManager_AddTimerPayload copies into a timer slot.
+#define SCENE_MANAGER_TIMER_PAYLOAD_SIZE 32
+
+// How SceneManager_Run spaces drawn frames. Fixed caps at the target rate,
+// Adaptive does the same but drops to a low rate when there is no input.
+typedef enum SceneManager_FramePacing
+{
+    FramePacing_VSync,
+    FramePacing_Uncapped,
+    FramePacing_Fixed,
+    FramePacing_Adaptive,
+} SceneManager_FramePacing;
+
+// Intervals between consecutive drawn frames, in milliseconds, over the
+// last complete sample window. Jitter is their standard deviation.
+typedef struct SceneManager_FrameStats
+{
+    int frames;
+    double averageMs;
+    double jitterMs;
+    double minMs;
+    double maxMs;
+} SceneManager_FrameStats;
+
 typedef struct SceneManager_CurrentScene
 {
     SceneManager_NewCallback onNew;
@@ -55,9 +82,19 @@ typedef struct SceneManager_CurrentScene
 SceneManager *SceneManager_New(Window *window, Graphics *graphics);
 void SceneManager_Delete(SceneManager * const self);
 void SceneManager_GoTo(SceneManager * const self, const SceneManager_CurrentScene *scene);
-void SceneManager_AddTimer(SceneManager * const self, Uint32 interval, SceneManager_TimerCallback callback, void *userdata);
+SceneManager_TimerHandle SceneManager_AddTimer(SceneManager * const self, Uint32 interval,
+                                               SceneManager_TimerCallback callback, void *userdata);
+SceneManager_TimerHandle SceneManager_AddTimerPayload(SceneManager * const self, Uint32 interval,
+                                                      SceneManager_TimerCallback callback,
+                                                      const void *payload, size_t size);
+bool SceneManager_CancelTimer(SceneManager * const self, SceneManager_TimerHandle handle);
+bool SceneManager_RescheduleTimer(SceneManager * const self, SceneManager_TimerHandle handle, Uint32 interval);
 void SceneManager_ClearTimers(SceneManager * const self);
 void SceneManager_Run(SceneManager * const self);
+void SceneManager_SetFixedTimestep(SceneManager * const self, double step);
+void SceneManager_SetFramePacing(SceneManager * const self, SceneManager_FramePacing pacing, int targetFps);
+SceneManager_FramePacing SceneManager_GetFramePacing(SceneManager * const self);
+SceneManager_FrameStats SceneManager_GetFrameStats(SceneManager * const self);
 Window *SceneManager_Window(SceneManager * const self);
 Graphics *SceneManager_Graphics(SceneManager * const self);
 
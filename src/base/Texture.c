@@ -24,53 +24,80 @@ SOFTWARE.
 
 #include "Texture.h"
 #include "Box.h"
-#include "DataZipFile.h"
+#include "Damage.h"
+#include "Graphics.h"
+#include "GlyphAtlas.h"
+#include "ImageLoader.h"
+#include "RenderBatch.h"
+#include "TextureCache.h"
 
 #include "malloc.h"
 
-#include <SDL2/SDL_image.h>
-#include <SDL2/SDL_ttf.h>
-
 #include <stdio.h>
 
 struct Texture
 {
+    Graphics *graphics;
     SDL_Renderer *renderer;
+    RenderBatch *batch;
     SDL_Texture *texture;
+    TextureCache *cache;
+    TextureCacheEntry *cacheEntry;
     int w;
     int h;
 
     Box *box;
     char *text;
-    TTF_Font *font;
+    size_t textCapacity;
+    GlyphAtlas *glyphAtlas;
     int fontSize;
     bool reloadFont;
     SDL_Color textColor;
 
     SDL_Rect srcrect;
     double angle;
+    SDL_Color placeholderColor;
+    Uint32 version;
+    Uint32 cacheGeneration;
 };
 
+// Shared by every texture, so a new texture never repeats an old one's version.
+static Uint32 versionCounter = 0;
+
 bool Texture_CreateTexture(Texture * const self, SDL_Surface *surface);
+void Texture_ReleaseTexture(Texture * const self);
+void Texture_SyncCacheEntry(Texture * const self);
+void Texture_Invalidate(Texture * const self);
+void Texture_BoxOnUpdateEvent(Box * const box, void *userdata);
 
-Texture *Texture_New(SDL_Renderer *renderer)
+Texture *Texture_New(Graphics *graphics)
 {
     Texture * const self = malloc(sizeof (Texture));
 
-    self->renderer = renderer;
+    self->graphics = graphics;
+    self->renderer = Graphics_GetRenderer(graphics);
+    self->batch = Graphics_GetRenderBatch(graphics);
     self->texture = NULL;
+    self->cache = NULL;
+    self->cacheEntry = NULL;
     self->w = 0;
     self->h = 0;
 
     self->box = Box_New(0.f, 0.f, 0.f, 0.f);
     self->text = NULL;
-    self->font = NULL;
+    self->textCapacity = 0;
+    self->glyphAtlas = NULL;
     self->fontSize = 16;
     self->reloadFont = false;
     self->textColor = (SDL_Color) {60, 60, 60, 255};
 
     self->srcrect = (SDL_Rect) {0, 0, 0, 0};
     self->angle = 0.0;
+    self->placeholderColor = (SDL_Color) {150, 150, 150, 255};
+    self->version = ++versionCounter;
+    self->cacheGeneration = 0;
+
+    Box_SetOnPressEvent(self->box, Texture_BoxOnUpdateEvent, self);
 
     return self;
 }
@@ -82,8 +109,7 @@ void Texture_Delete(Texture * const self)
 
     Box_Delete(self->box);
 
-    SDL_DestroyTexture(self->texture);
-    TTF_CloseFont(self->font);
+    Texture_ReleaseTexture(self);
 
     free(self->text);
     free(self);
@@ -91,45 +117,79 @@ void Texture_Delete(Texture * const self)
 
 bool Texture_LoadImageFromFile(Texture * const self, const char *fileName)
 {
-#ifdef USE_DATA_ZIP
-    SDL_Surface *surface = IMG_Load_RW(DataZipFile_Load_RW(fileName), 1);
-#else
-    SDL_Surface *surface = IMG_Load(fileName);
-#endif
+    return Texture_CreateTexture(self, ImageLoader_Load(fileName));
+}
+
+bool Texture_LoadImageFromCache(Texture * const self, TextureCache *cache, const char *fileName)
+{
+    TextureCacheEntry *entry = TextureCache_Acquire(cache, fileName);
+
+    if (!entry)
+        return false;
+
+    Texture_ReleaseTexture(self);
+
+    self->glyphAtlas = NULL;
+    self->cache = cache;
+    self->cacheEntry = entry;
+
+    Texture_SyncCacheEntry(self);
+    Texture_Invalidate(self);
+
+    return true;
+}
+
+void Texture_SetPlaceholderSize(Texture * const self, int w, int h)
+{
+    if (self->texture || self->glyphAtlas)
+        return;
 
-    return Texture_CreateTexture(self, surface);
+    self->w = w;
+    self->h = h;
+
+    Box_SetSize(self->box, w, h);
 }
 
 bool Texture_MakeText(Texture * const self)
 {
-    if (!self->font || self->reloadFont)
+    if (!self->glyphAtlas || self->reloadFont)
     {
-        TTF_CloseFont(self->font);
-
-#ifdef USE_DATA_ZIP
-        if (!(self->font = TTF_OpenFontRW(DataZipFile_Load_RW("fonts/NotoSans-Bold.ttf"), 1, self->fontSize)))
-#else
-        if (!(self->font = TTF_OpenFont("fonts/NotoSans-Bold.ttf", self->fontSize)))
-#endif
+        if (!(self->glyphAtlas = Graphics_GetGlyphAtlas(self->graphics, "fonts/NotoSans-Bold.ttf", self->fontSize)))
         {
-            printf( "Failed to load font! SDL_ttf Error: %s\n", TTF_GetError());
+            printf("Failed to load font! SDL Error: %s\n", SDL_GetError());
             return false;
         }
 
         self->reloadFont = false;
     }
 
-    SDL_Surface *surface = TTF_RenderUTF8_Blended(self->font, self->text, self->textColor);
+    Texture_ReleaseTexture(self);
+    GlyphAtlas_MeasureText(self->glyphAtlas, self->text, &self->w, &self->h);
+
+    self->srcrect = (SDL_Rect) {0, 0, self->w, self->h};
+    Box_SetSize(self->box, self->w, self->h);
 
-    return Texture_CreateTexture(self, surface);
+    Texture_Invalidate(self);
+
+    return true;
 }
 
 void Texture_SetText(Texture * const self, const char *text)
 {
-    free(self->text);
-
     const size_t size = strlen(text) + 1;
-    self->text = malloc(size);
+
+    if (self->text && strcmp(self->text, text) == 0)
+        return;
+
+    Texture_Invalidate(self);
+
+    if (size > self->textCapacity)
+    {
+        free(self->text);
+
+        self->text = malloc(size);
+        self->textCapacity = size;
+    }
 
     memcpy(self->text, text, size);
 }
@@ -140,6 +200,8 @@ void Texture_SetTextSize(Texture * const self, int ptsize)
     {
         self->fontSize = ptsize;
         self->reloadFont = true;
+
+        Texture_Invalidate(self);
     }
 }
 
@@ -149,6 +211,8 @@ void Texture_SetTextColor(Texture * const self, const SDL_Color *color)
         self->textColor = *color;
     else
         self->textColor = (SDL_Color) {60, 60, 60, 255};
+
+    Texture_Invalidate(self);
 }
 
 void Texture_SetTextColorRGB(Texture * const self, uint8_t r, uint8_t g, uint8_t b)
@@ -157,6 +221,8 @@ void Texture_SetTextColorRGB(Texture * const self, uint8_t r, uint8_t g, uint8_t
     self->textColor.g = g;
     self->textColor.b = b;
     self->textColor.a = 255;
+
+    Texture_Invalidate(self);
 }
 
 void Texture_SetTextColorRGBA(Texture * const self, uint8_t r, uint8_t g, uint8_t b, uint8_t a)
@@ -165,37 +231,109 @@ void Texture_SetTextColorRGBA(Texture * const self, uint8_t r, uint8_t g, uint8_
     self->textColor.g = g;
     self->textColor.b = b;
     self->textColor.a = a;
+
+    Texture_Invalidate(self);
 }
 
 void Texture_SetSourceRect(Texture * const self, SDL_Rect srcrect)
 {
     self->srcrect = srcrect;
+
+    Texture_Invalidate(self);
 }
 
 void Texture_SetAngle(Texture * const self, double angle)
 {
+    if (self->angle != angle)
+        Texture_Invalidate(self);
+
     self->angle = angle;
 }
 
 void Texture_Draw(Texture * const self)
 {
-    if (self->texture)
+    TextureQuad quad;
+
+    if (Texture_GetQuad(self, &quad))
+    {
+        if (quad.texture)
+            RenderBatch_AddSprite(self->batch, quad.texture, &quad.srcrect, &quad.dstrect, quad.color);
+        else
+            RenderBatch_AddRect(self->batch, &quad.dstrect, quad.color);
+    }
+    else if (self->glyphAtlas)
+    {
+        GlyphAtlas_DrawText(self->glyphAtlas, self->text, Box_Rect(self->box), self->textColor);
+    }
+    else if (self->texture)
+    {
+        RenderBatch_Flush(self->batch);
         SDL_RenderCopyExF(self->renderer, self->texture, &self->srcrect, Box_Rect(self->box), self->angle, NULL, SDL_FLIP_NONE);
+    }
+}
+
+bool Texture_GetQuad(Texture * const self, TextureQuad *quad)
+{
+    if (self->glyphAtlas)
+        return false;
+
+    if (self->cacheEntry)
+        Texture_SyncCacheEntry(self);
+
+    // Rotated textures need SDL_RenderCopyEx; without a texture or cache entry there is nothing to draw.
+    if ((self->texture && self->angle != 0.0) || (!self->texture && !self->cacheEntry))
+        return false;
+
+    quad->texture = self->texture;
+    quad->srcrect = self->srcrect;
+    quad->dstrect = *Box_Rect(self->box);
+    quad->color = self->placeholderColor;
+
+    if (self->texture)
+    {
+        // Geometry ignores the texture's own modulation, so carry it on the vertices.
+        quad->color = (SDL_Color) {255, 255, 255, 255};
+
+        SDL_GetTextureColorMod(self->texture, &quad->color.r, &quad->color.g, &quad->color.b);
+        SDL_GetTextureAlphaMod(self->texture, &quad->color.a);
+    }
+
+    return true;
+}
+
+Uint32 Texture_Touch(Texture * const self)
+{
+    if (self->cacheEntry)
+    {
+        const Uint32 generation = TextureCache_GetGeneration(self->cache);
+
+        TextureCache_Use(self->cache, self->cacheEntry);
+
+        // Some cache entry changed since the last look, this one may be among them.
+        if (generation != self->cacheGeneration)
+        {
+            self->cacheGeneration = generation;
+            self->version = ++versionCounter;
+        }
+    }
+
+    return self->version;
 }
 
 bool Texture_CreateTexture(Texture * const self, SDL_Surface *surface)
 {
+    Texture_ReleaseTexture(self);
+
+    self->glyphAtlas = NULL;
+
     if (surface)
     {
-        if (self->texture)
-            SDL_DestroyTexture(self->texture);
-            //SDL_UpdateTexture(self->texture, NULL, surface->pixels, surface->pitch);
-        //else
-
         self->texture = SDL_CreateTextureFromSurface(self->renderer, surface);
 
         if (self->texture)
         {
+            Texture_Invalidate(self);
+
             self->w = surface->w;
             self->h = surface->h;
             self->srcrect.w = surface->w;
@@ -211,13 +349,64 @@ bool Texture_CreateTexture(Texture * const self, SDL_Surface *surface)
     }
     else
     {
-        self->texture = NULL;
-        printf("Unable to render surface! SDL Error: %s\n", TTF_GetError());
+        printf("Unable to render surface! SDL Error: %s\n", SDL_GetError());
     }
 
     return self->texture != NULL;
 }
 
+void Texture_ReleaseTexture(Texture * const self)
+{
+    if (self->cacheEntry)
+        TextureCache_Release(self->cache, self->cacheEntry);
+    else
+        SDL_DestroyTexture(self->texture);
+
+    if (self->texture || self->cacheEntry)
+        Texture_Invalidate(self);
+
+    self->texture = NULL;
+    self->cache = NULL;
+    self->cacheEntry = NULL;
+}
+
+void Texture_SyncCacheEntry(Texture * const self)
+{
+    // Marks the entry as drawn; NULL while loading or after an eviction.
+    if (!(self->texture = TextureCache_Use(self->cache, self->cacheEntry)))
+        return;
+
+    const SDL_Rect rect = TextureCache_GetRect(self->cache, self->cacheEntry);
+    int w, h;
+
+    TextureCache_GetSize(self->cache, self->cacheEntry, &w, &h);
+
+    if (rect.x == self->srcrect.x && rect.y == self->srcrect.y && rect.w == self->srcrect.w
+            && rect.h == self->srcrect.h && w == self->w && h == self->h)
+        return;
+
+    // The source rect may be a downscaled variant; the box keeps the logical size.
+    self->srcrect = rect;
+    self->w = w;
+    self->h = h;
+
+    Box_SetSize(self->box, self->w, self->h);
+}
+
+void Texture_Invalidate(Texture * const self)
+{
+    self->version = ++versionCounter;
+    Damage_Invalidate();
+}
+
+void Texture_BoxOnUpdateEvent(Box * const box, void *userdata)
+{
+    Texture * const self = userdata;
+
+    (void)box;
+    self->version = ++versionCounter;
+}
+
 int Texture_GetWidth(Texture * const self)
 {
     return self->w;
@@ -33,13 +33,28 @@ extern "C" {
 #endif
 
 typedef struct Box Box;
+typedef struct TextureCache TextureCache;
+typedef struct Graphics Graphics;
 
 typedef struct Texture Texture;
 
-Texture *Texture_New(SDL_Renderer *renderer);
+// What Texture_Draw submits for an image, resolved once so a retained
+// node can emit it straight to the batch. A NULL texture stands for the
+// placeholder rect shown while a cached image is loading.
+typedef struct TextureQuad
+{
+    SDL_Texture *texture;
+    SDL_Rect srcrect;
+    SDL_FRect dstrect;
+    SDL_Color color;
+} TextureQuad;
+
+Texture *Texture_New(Graphics *graphics);
 void Texture_Delete(Texture * const self);
 
 bool Texture_LoadImageFromFile(Texture * const self, const char *fileName);
+bool Texture_LoadImageFromCache(Texture * const self, TextureCache *cache, const char *fileName);
+void Texture_SetPlaceholderSize(Texture * const self, int w, int h);
 
 bool Texture_MakeText(Texture * const self);
 void Texture_SetText(Texture * const self, const char *text);
@@ -53,6 +68,13 @@ void Texture_SetAngle(Texture * const self, double angle);
 
 void Texture_Draw(Texture * const self);
 
+// Texture_GetQuad returns false for text, rotated textures and empty
+// slots, which still go through Texture_Draw. Texture_Touch marks a
+// cached image as drawn and returns a version that changes whenever the
+// quad would; changes made straight on the SDL_Texture are not tracked.
+bool Texture_GetQuad(Texture * const self, TextureQuad *quad);
+Uint32 Texture_Touch(Texture * const self);
+
 int Texture_GetWidth(Texture * const self);
 int Texture_GetHeight(Texture * const self);
 Box *Texture_Box(Texture * const self);
@@ -0,0 +1,228 @@
+//-------------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Fábio Pichler
+/*-------------------------------------------------------------------------------
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+-------------------------------------------------------------------------------*/
+
+#include "TextureAtlas.h"
+#include "RectPacker.h"
+#include "RenderBatch.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define WHITE_TEXEL_SIZE 4
+
+typedef struct AtlasItem
+{
+    char *name;
+    SDL_Rect rect;
+} AtlasItem;
+
+struct TextureAtlas
+{
+    SDL_Renderer *renderer;
+    RenderBatch *batch;
+    SDL_Surface *surface;
+    SDL_Texture *texture;
+    RectPacker *packer;
+    SDL_Rect whiteRect;
+    int width;
+    int height;
+
+    AtlasItem *items;
+    int count;
+    int capacity;
+};
+
+void TextureAtlas_Setup(TextureAtlas * const self);
+void TextureAtlas_Release(TextureAtlas * const self);
+
+TextureAtlas *TextureAtlas_New(SDL_Renderer *renderer, RenderBatch *batch, int width, int height)
+{
+    TextureAtlas * const self = malloc(sizeof (TextureAtlas));
+
+    SDL_RendererInfo info;
+
+    if (SDL_GetRendererInfo(renderer, &info) == 0)
+    {
+        if (info.max_texture_width > 0 && width > info.max_texture_width)
+            width = info.max_texture_width;
+
+        if (info.max_texture_height > 0 && height > info.max_texture_height)
+            height = info.max_texture_height;
+    }
+
+    self->renderer = renderer;
+    self->batch = batch;
+    self->texture = NULL;
+    self->width = width;
+    self->height = height;
+
+    self->items = NULL;
+    self->count = 0;
+    self->capacity = 0;
+
+    TextureAtlas_Setup(self);
+
+    return self;
+}
+
+void TextureAtlas_Delete(TextureAtlas * const self)
+{
+    if (!self)
+        return;
+
+    TextureAtlas_Release(self);
+    free(self->items);
+
+    free(self);
+}
+
+void TextureAtlas_Clear(TextureAtlas * const self)
+{
+    // Recorded quads may still sample the page, submit them before it goes away.
+    if (self->texture && self->batch)
+        RenderBatch_Flush(self->batch);
+
+    TextureAtlas_Release(self);
+    TextureAtlas_Setup(self);
+}
+
+void TextureAtlas_Setup(TextureAtlas * const self)
+{
+    self->surface = SDL_CreateRGBSurfaceWithFormat(0, self->width, self->height, 32, SDL_PIXELFORMAT_RGBA32);
+    self->packer = RectPacker_New(self->width, self->height, 2);
+    self->whiteRect = (SDL_Rect) {0, 0, 0, 0};
+
+    if (self->surface)
+    {
+        SDL_FillRect(self->surface, NULL, 0);
+
+        if (RectPacker_Pack(self->packer, WHITE_TEXEL_SIZE, WHITE_TEXEL_SIZE, &self->whiteRect))
+            SDL_FillRect(self->surface, &self->whiteRect, SDL_MapRGBA(self->surface->format, 255, 255, 255, 255));
+    }
+    else
+    {
+        printf("Unable to create atlas surface! SDL Error: %s\n", SDL_GetError());
+    }
+}
+
+void TextureAtlas_Release(TextureAtlas * const self)
+{
+    for (int i = 0; i < self->count; ++i)
+        free(self->items[i].name);
+
+    self->count = 0;
+
+    RectPacker_Delete(self->packer);
+    SDL_FreeSurface(self->surface);
+
+    if (self->texture)
+    {
+        if (self->batch)
+            RenderBatch_SetSolidTexel(self->batch, NULL, self->whiteRect);
+
+        SDL_DestroyTexture(self->texture);
+        self->texture = NULL;
+    }
+}
+
+bool TextureAtlas_AddSurface(TextureAtlas * const self, const char *name, SDL_Surface *surface)
+{
+    SDL_Rect rect;
+
+    if (!self->surface || self->texture)
+        return false;
+
+    if (!RectPacker_Pack(self->packer, surface->w, surface->h, &rect))
+    {
+        printf("Texture atlas is full, %s was not packed.\n", name);
+        return false;
+    }
+
+    SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_NONE);
+
+    if (SDL_BlitSurface(surface, NULL, self->surface, &rect) != 0)
+    {
+        printf("Unable to copy %s into the atlas! SDL Error: %s\n", name, SDL_GetError());
+        return false;
+    }
+
+    if (self->count == self->capacity)
+    {
+        self->capacity = self->capacity ? self->capacity * 2 : 16;
+        self->items = realloc(self->items, sizeof (AtlasItem) * self->capacity);
+    }
+
+    const size_t size = strlen(name) + 1;
+    AtlasItem *item = &self->items[self->count++];
+
+    item->name = malloc(size);
+    item->rect = rect;
+    memcpy(item->name, name, size);
+
+    return true;
+}
+
+bool TextureAtlas_Build(TextureAtlas * const self)
+{
+    if (!self->surface || self->texture)
+        return self->texture != NULL;
+
+    self->texture = SDL_CreateTextureFromSurface(self->renderer, self->surface);
+
+    if (!self->texture)
+    {
+        printf("Unable to create atlas texture! SDL Error: %s\n", SDL_GetError());
+        return false;
+    }
+
+    SDL_SetTextureBlendMode(self->texture, SDL_BLENDMODE_BLEND);
+
+    if (self->batch && self->whiteRect.w > 0)
+        RenderBatch_SetSolidTexel(self->batch, self->texture, self->whiteRect);
+
+    SDL_FreeSurface(self->surface);
+    self->surface = NULL;
+
+    return true;
+}
+
+SDL_Texture *TextureAtlas_GetTexture(TextureAtlas * const self)
+{
+    return self->texture;
+}
+
+int TextureAtlas_GetCount(TextureAtlas * const self)
+{
+    return self->count;
+}
+
+const char *TextureAtlas_GetName(TextureAtlas * const self, int index)
+{
+    return self->items[index].name;
+}
+
+SDL_Rect TextureAtlas_GetRect(TextureAtlas * const self, int index)
+{
+    return self->items[index].rect;
+}
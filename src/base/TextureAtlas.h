@@ -0,0 +1,57 @@
+//-------------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Fábio Pichler
+/*-------------------------------------------------------------------------------
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+-------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Packs several images into a single texture. Images are added first and
+// uploaded together by TextureAtlas_Build. Each atlas also carries a small
+// white block, registered with the RenderBatch so solid quads can share
+// its draw call. TextureAtlas_Clear drops the page and every image so the
+// atlas can be packed again, e.g. at a new output scale.
+
+typedef struct TextureAtlas TextureAtlas;
+typedef struct RenderBatch RenderBatch;
+
+TextureAtlas *TextureAtlas_New(SDL_Renderer *renderer, RenderBatch *batch, int width, int height);
+void TextureAtlas_Delete(TextureAtlas * const self);
+void TextureAtlas_Clear(TextureAtlas * const self);
+
+bool TextureAtlas_AddSurface(TextureAtlas * const self, const char *name, SDL_Surface *surface);
+bool TextureAtlas_Build(TextureAtlas * const self);
+
+SDL_Texture *TextureAtlas_GetTexture(TextureAtlas * const self);
+int TextureAtlas_GetCount(TextureAtlas * const self);
+const char *TextureAtlas_GetName(TextureAtlas * const self, int index);
+SDL_Rect TextureAtlas_GetRect(TextureAtlas * const self, int index);
+
+#ifdef __cplusplus
+}
+#endif
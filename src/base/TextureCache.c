@@ -0,0 +1,644 @@
+//-------------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Fábio Pichler
+/*-------------------------------------------------------------------------------
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+-------------------------------------------------------------------------------*/
+
+#include "TextureCache.h"
+#include "AssetLoader.h"
+#include "ImageLoader.h"
+#include "TextureAtlas.h"
+#include "ImageScaler.h"
+#include "Damage.h"
+#include "LinkedList.h"
+
+#include <stdio.h>
+#include <string.h>
+
+struct TextureCacheEntry
+{
+    char *fileName;
+    SDL_Texture *texture;
+    TextureAtlas *atlas;
+    SDL_Rect rect;
+    int width;
+    int height;
+    int refCount;
+    bool loading;
+    bool failed;
+    size_t bytes;
+    Uint32 lastUse;
+};
+
+struct TextureCache
+{
+    SDL_Renderer *renderer;
+    AssetLoader *loader;
+    LinkedList *entries;
+    LinkedList *atlases;
+
+    size_t residentBytes;
+    size_t budget;
+    Uint32 frame;
+    Uint32 generation;
+    float outputScale;
+};
+
+TextureCacheEntry *TextureCache_Find(TextureCache * const self, const char *fileName);
+TextureCacheEntry *TextureCache_Load(TextureCache * const self, const char *fileName);
+TextureCacheEntry *TextureCache_PushEntry(TextureCache * const self, const char *fileName, SDL_Texture *texture,
+                                          TextureAtlas *atlas, SDL_Rect rect);
+void TextureCache_Queue(TextureCache * const self, TextureCacheEntry *entry);
+void TextureCache_Reload(TextureCache * const self, TextureCacheEntry *entry);
+bool TextureCache_Upload(TextureCache * const self, TextureCacheEntry *entry, SDL_Surface *surface);
+void TextureCache_Evict(TextureCache * const self);
+void TextureCache_Unload(TextureCache * const self, TextureCacheEntry *entry);
+SDL_Surface *TextureCache_Downscale(TextureCache * const self, SDL_Surface *surface);
+void TextureCache_FinishAtlas(TextureCache * const self, TextureAtlas *atlas);
+void TextureCache_RebuildAtlas(TextureCache * const self, TextureAtlas *atlas);
+bool TextureCache_AddToAtlas(TextureCache * const self, TextureAtlas *atlas, const char *fileName, SDL_Surface *surface);
+static SDL_Texture *CreateTexture(SDL_Renderer *renderer, const char *fileName, SDL_Surface *surface);
+static size_t TextureBytes(SDL_Texture *texture);
+static void OnImageLoaded(void *userdata, const char *fileName, SDL_Surface *surface);
+static void DeleteEntry(TextureCacheEntry *entry);
+
+TextureCache *TextureCache_New(SDL_Renderer *renderer, AssetLoader *loader)
+{
+    TextureCache * const self = malloc(sizeof (TextureCache));
+
+    self->renderer = renderer;
+    self->loader = loader;
+    self->entries = LinkedList_New();
+    self->atlases = LinkedList_New();
+
+    self->residentBytes = 0;
+    self->budget = 0;
+    self->frame = 0;
+    self->generation = 0;
+    self->outputScale = 1.0f;
+
+    return self;
+}
+
+void TextureCache_Delete(TextureCache * const self)
+{
+    if (!self)
+        return;
+
+    for (LinkedListNode *iterator = LinkedList_GetFirst(self->entries); iterator != NULL;)
+    {
+        DeleteEntry(LinkedList_GetValuePtr(self->entries, iterator));
+        LinkedList_Next(self->entries, &iterator);
+    }
+
+    for (LinkedListNode *iterator = LinkedList_GetFirst(self->atlases); iterator != NULL;)
+    {
+        TextureAtlas_Delete(LinkedList_GetValuePtr(self->atlases, iterator));
+        LinkedList_Next(self->atlases, &iterator);
+    }
+
+    LinkedList_Delete(self->entries);
+    LinkedList_Delete(self->atlases);
+
+    free(self);
+}
+
+TextureCacheEntry *TextureCache_Acquire(TextureCache * const self, const char *fileName)
+{
+    TextureCacheEntry *entry = TextureCache_Find(self, fileName);
+
+    if (!entry && self->loader)
+    {
+        entry = TextureCache_PushEntry(self, fileName, NULL, NULL, (SDL_Rect) {0, 0, 0, 0});
+        TextureCache_Queue(self, entry);
+    }
+    else if (!entry)
+    {
+        entry = TextureCache_Load(self, fileName);
+    }
+
+    if (entry)
+        entry->refCount++;
+
+    return entry;
+}
+
+void TextureCache_Release(TextureCache * const self, TextureCacheEntry *entry)
+{
+    (void)self;
+
+    if (entry && entry->refCount > 0)
+        entry->refCount--;
+}
+
+void TextureCache_Purge(TextureCache * const self)
+{
+    for (LinkedListNode *iterator = LinkedList_GetFirst(self->entries); iterator != NULL;)
+    {
+        TextureCacheEntry *entry = LinkedList_GetValuePtr(self->entries, iterator);
+
+        if (entry->refCount == 0 && !entry->atlas && !entry->loading)
+        {
+            self->residentBytes -= entry->bytes;
+
+            DeleteEntry(entry);
+            LinkedList_Remove(self->entries, &iterator);
+        }
+        else
+        {
+            LinkedList_Next(self->entries, &iterator);
+        }
+    }
+}
+
+void TextureCache_AddAtlasImage(TextureCache * const self, TextureAtlas *atlas, const char *fileName)
+{
+    if (TextureCache_Find(self, fileName))
+        return;
+
+    TextureCacheEntry *entry = TextureCache_PushEntry(self, fileName, NULL, atlas, (SDL_Rect) {0, 0, 0, 0});
+
+    if (self->loader)
+    {
+        TextureCache_Queue(self, entry);
+        return;
+    }
+
+    SDL_Surface *surface = ImageLoader_Load(fileName);
+
+    if (!surface)
+    {
+        printf("Unable to load image %s! SDL_image Error: %s\n", fileName, SDL_GetError());
+        entry->failed = true;
+
+        return;
+    }
+
+    // The entry keeps the full size, the atlas may hold a downscaled copy.
+    TextureCache_AddToAtlas(self, atlas, fileName, surface);
+
+    entry->width = surface->w;
+    entry->height = surface->h;
+
+    SDL_FreeSurface(surface);
+}
+
+void TextureCache_AddAtlas(TextureCache * const self, TextureAtlas *atlas)
+{
+    LinkedList_PushPtr(self->atlases, atlas);
+    TextureCache_FinishAtlas(self, atlas);
+}
+
+void TextureCache_SetBudget(TextureCache * const self, size_t bytes)
+{
+    self->budget = bytes;
+}
+
+size_t TextureCache_GetResidentBytes(TextureCache * const self)
+{
+    return self->residentBytes;
+}
+
+void TextureCache_NextFrame(TextureCache * const self)
+{
+    self->frame++;
+
+    if (self->budget > 0 && self->residentBytes > self->budget)
+        TextureCache_Evict(self);
+}
+
+SDL_Texture *TextureCache_Use(TextureCache * const self, TextureCacheEntry *entry)
+{
+    entry->lastUse = self->frame;
+
+    // Evicted: bring it back from its source, the caller draws a placeholder meanwhile.
+    if (!entry->texture && !entry->loading && !entry->failed && !entry->atlas)
+        TextureCache_Reload(self, entry);
+
+    return entry->texture;
+}
+
+void TextureCache_SetOutputScale(TextureCache * const self, float scale)
+{
+    const bool downscaled = self->outputScale < 1.0f || scale < 1.0f;
+
+    if (SDL_fabs(scale - self->outputScale) < 0.01)
+        return;
+
+    self->outputScale = scale;
+
+    if (!downscaled)
+        return;
+
+    self->generation++;
+    Damage_Invalidate();
+
+    // Standalone textures come back at the new size the next time they are drawn.
+    for (LinkedListNode *iterator = LinkedList_GetFirst(self->entries); iterator != NULL;)
+    {
+        TextureCacheEntry *entry = LinkedList_GetValuePtr(self->entries, iterator);
+
+        if (entry->texture && !entry->atlas)
+            TextureCache_Unload(self, entry);
+
+        LinkedList_Next(self->entries, &iterator);
+    }
+
+    // Atlas pages are packed again from their sources at the new size.
+    for (LinkedListNode *iterator = LinkedList_GetFirst(self->atlases); iterator != NULL;)
+    {
+        TextureCache_RebuildAtlas(self, LinkedList_GetValuePtr(self->atlases, iterator));
+        LinkedList_Next(self->atlases, &iterator);
+    }
+}
+
+Uint32 TextureCache_GetGeneration(TextureCache * const self)
+{
+    return self->generation;
+}
+
+SDL_Texture *TextureCache_GetTexture(TextureCache * const self, TextureCacheEntry *entry)
+{
+    (void)self;
+
+    return entry->texture;
+}
+
+SDL_Rect TextureCache_GetRect(TextureCache * const self, TextureCacheEntry *entry)
+{
+    (void)self;
+
+    return entry->rect;
+}
+
+void TextureCache_GetSize(TextureCache * const self, TextureCacheEntry *entry, int *w, int *h)
+{
+    (void)self;
+
+    *w = entry->width;
+    *h = entry->height;
+}
+
+TextureCacheEntry *TextureCache_Find(TextureCache * const self, const char *fileName)
+{
+    for (LinkedListNode *iterator = LinkedList_GetFirst(self->entries); iterator != NULL;)
+    {
+        TextureCacheEntry *entry = LinkedList_GetValuePtr(self->entries, iterator);
+
+        if (strcmp(entry->fileName, fileName) == 0)
+            return entry;
+
+        LinkedList_Next(self->entries, &iterator);
+    }
+
+    return NULL;
+}
+
+TextureCacheEntry *TextureCache_Load(TextureCache * const self, const char *fileName)
+{
+    SDL_Surface *surface = ImageLoader_Load(fileName);
+
+    if (!surface)
+    {
+        printf("Unable to load image %s! SDL_image Error: %s\n", fileName, SDL_GetError());
+        return NULL;
+    }
+
+    TextureCacheEntry *entry = TextureCache_PushEntry(self, fileName, NULL, NULL, (SDL_Rect) {0, 0, 0, 0});
+
+    if (!TextureCache_Upload(self, entry, surface))
+    {
+        LinkedList_RemoveFromValuePtr(self->entries, entry);
+        DeleteEntry(entry);
+        entry = NULL;
+    }
+
+    SDL_FreeSurface(surface);
+
+    return entry;
+}
+
+TextureCacheEntry *TextureCache_PushEntry(TextureCache * const self, const char *fileName, SDL_Texture *texture,
+                                          TextureAtlas *atlas, SDL_Rect rect)
+{
+    TextureCacheEntry *entry = malloc(sizeof (TextureCacheEntry));
+    const size_t size = strlen(fileName) + 1;
+
+    entry->fileName = malloc(size);
+    memcpy(entry->fileName, fileName, size);
+
+    entry->texture = texture;
+    entry->atlas = atlas;
+    entry->rect = rect;
+    entry->width = rect.w;
+    entry->height = rect.h;
+    entry->refCount = 0;
+    entry->loading = false;
+    entry->failed = false;
+    entry->bytes = 0;
+    entry->lastUse = self->frame;
+
+    LinkedList_PushPtr(self->entries, entry);
+
+    return entry;
+}
+
+void TextureCache_Queue(TextureCache * const self, TextureCacheEntry *entry)
+{
+    entry->loading = true;
+    AssetLoader_LoadImage(self->loader, entry->fileName, OnImageLoaded, self);
+}
+
+void TextureCache_Reload(TextureCache * const self, TextureCacheEntry *entry)
+{
+    if (self->loader)
+    {
+        TextureCache_Queue(self, entry);
+        return;
+    }
+
+    SDL_Surface *surface = ImageLoader_Load(entry->fileName);
+
+    if (!surface)
+    {
+        printf("Unable to load image %s! SDL_image Error: %s\n", entry->fileName, SDL_GetError());
+        entry->failed = true;
+
+        return;
+    }
+
+    TextureCache_Upload(self, entry, surface);
+    SDL_FreeSurface(surface);
+}
+
+bool TextureCache_Upload(TextureCache * const self, TextureCacheEntry *entry, SDL_Surface *surface)
+{
+    SDL_Surface *variant = TextureCache_Downscale(self, surface);
+    SDL_Surface *pixels = variant ? variant : surface;
+
+    entry->texture = CreateTexture(self->renderer, entry->fileName, pixels);
+    entry->rect = (SDL_Rect) {0, 0, pixels->w, pixels->h};
+    entry->width = surface->w;
+    entry->height = surface->h;
+
+    SDL_FreeSurface(variant);
+
+    self->generation++;
+
+    if (!entry->texture)
+    {
+        entry->failed = true;
+        return false;
+    }
+
+    entry->bytes = TextureBytes(entry->texture);
+    entry->lastUse = self->frame;
+
+    self->residentBytes += entry->bytes;
+
+    // A placeholder may be on screen waiting for this texture.
+    Damage_Invalidate();
+
+    return true;
+}
+
+void TextureCache_Evict(TextureCache * const self)
+{
+    while (self->residentBytes > self->budget)
+    {
+        TextureCacheEntry *oldest = NULL;
+
+        for (LinkedListNode *iterator = LinkedList_GetFirst(self->entries); iterator != NULL;)
+        {
+            TextureCacheEntry *entry = LinkedList_GetValuePtr(self->entries, iterator);
+
+            // Atlas pages are shared and stay pinned; anything drawn last frame is still on screen.
+            if (entry->texture && !entry->atlas && entry->lastUse + 1 < self->frame
+                    && (!oldest || entry->lastUse < oldest->lastUse))
+                oldest = entry;
+
+            LinkedList_Next(self->entries, &iterator);
+        }
+
+        if (!oldest)
+            return;
+
+        TextureCache_Unload(self, oldest);
+    }
+}
+
+void TextureCache_Unload(TextureCache * const self, TextureCacheEntry *entry)
+{
+    SDL_DestroyTexture(entry->texture);
+
+    self->residentBytes -= entry->bytes;
+    self->generation++;
+    entry->texture = NULL;
+    entry->bytes = 0;
+}
+
+SDL_Surface *TextureCache_Downscale(TextureCache * const self, SDL_Surface *surface)
+{
+    // Upscaling is left to the renderer, there is nothing sharper to build it from.
+    if (self->outputScale >= 1.0f)
+        return NULL;
+
+    const int w = SDL_max(1, (int)(surface->w * self->outputScale + 0.5f));
+    const int h = SDL_max(1, (int)(surface->h * self->outputScale + 0.5f));
+
+    return ImageScaler_Downscale(surface, w, h);
+}
+
+void TextureCache_FinishAtlas(TextureCache * const self, TextureAtlas *atlas)
+{
+    for (LinkedListNode *iterator = LinkedList_GetFirst(self->entries); iterator != NULL;)
+    {
+        TextureCacheEntry *entry = LinkedList_GetValuePtr(self->entries, iterator);
+
+        // Wait until every image queued for this atlas has been decoded.
+        if (entry->atlas == atlas && entry->loading)
+            return;
+
+        LinkedList_Next(self->entries, &iterator);
+    }
+
+    const bool built = TextureAtlas_Build(atlas);
+    SDL_Texture *texture = TextureAtlas_GetTexture(atlas);
+
+    if (built)
+    {
+        self->residentBytes += TextureBytes(texture);
+        self->generation++;
+        Damage_Invalidate();
+    }
+
+    for (int i = 0; built && i < TextureAtlas_GetCount(atlas); ++i)
+    {
+        const char *fileName = TextureAtlas_GetName(atlas, i);
+        TextureCacheEntry *entry = TextureCache_Find(self, fileName);
+
+        // Textures already handed out keep their own copy.
+        if (!entry)
+        {
+            TextureCache_PushEntry(self, fileName, texture, atlas, TextureAtlas_GetRect(atlas, i));
+        }
+        else if (entry->atlas == atlas)
+        {
+            entry->texture = texture;
+            entry->rect = TextureAtlas_GetRect(atlas, i);
+        }
+    }
+
+    // Images that did not fit (or the whole atlas, if it could not be built) load on their own.
+    for (LinkedListNode *iterator = LinkedList_GetFirst(self->entries); iterator != NULL;)
+    {
+        TextureCacheEntry *entry = LinkedList_GetValuePtr(self->entries, iterator);
+
+        if (entry->atlas == atlas && !entry->texture && !entry->failed)
+        {
+            entry->atlas = NULL;
+            TextureCache_Reload(self, entry);
+        }
+
+        LinkedList_Next(self->entries, &iterator);
+    }
+}
+
+void TextureCache_RebuildAtlas(TextureCache * const self, TextureAtlas *atlas)
+{
+    SDL_Texture *texture = TextureAtlas_GetTexture(atlas);
+
+    if (texture)
+        self->residentBytes -= TextureBytes(texture);
+
+    TextureAtlas_Clear(atlas);
+
+    for (LinkedListNode *iterator = LinkedList_GetFirst(self->entries); iterator != NULL;)
+    {
+        TextureCacheEntry *entry = LinkedList_GetValuePtr(self->entries, iterator);
+
+        // Images still decoding are packed at the new scale when they arrive.
+        if (entry->atlas == atlas && !entry->loading && !entry->failed)
+        {
+            entry->texture = NULL;
+            entry->rect = (SDL_Rect) {0, 0, 0, 0};
+
+            if (self->loader)
+            {
+                TextureCache_Queue(self, entry);
+            }
+            else
+            {
+                SDL_Surface *surface = ImageLoader_Load(entry->fileName);
+
+                if (surface)
+                    TextureCache_AddToAtlas(self, atlas, entry->fileName, surface);
+                else
+                    entry->failed = true;
+
+                SDL_FreeSurface(surface);
+            }
+        }
+
+        LinkedList_Next(self->entries, &iterator);
+    }
+
+    TextureCache_FinishAtlas(self, atlas);
+}
+
+bool TextureCache_AddToAtlas(TextureCache * const self, TextureAtlas *atlas, const char *fileName, SDL_Surface *surface)
+{
+    SDL_Surface *variant = TextureCache_Downscale(self, surface);
+    const bool added = TextureAtlas_AddSurface(atlas, fileName, variant ? variant : surface);
+
+    SDL_FreeSurface(variant);
+
+    return added;
+}
+
+SDL_Texture *CreateTexture(SDL_Renderer *renderer, const char *fileName, SDL_Surface *surface)
+{
+    SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, surface);
+
+    if (!texture)
+        printf("Unable to create texture from %s! SDL Error: %s\n", fileName, SDL_GetError());
+
+    return texture;
+}
+
+void OnImageLoaded(void *userdata, const char *fileName, SDL_Surface *surface)
+{
+    TextureCache * const self = userdata;
+    TextureCacheEntry *entry = TextureCache_Find(self, fileName);
+
+    if (!entry || !entry->loading)
+        return;
+
+    entry->loading = false;
+
+    if (!surface)
+        entry->failed = true;
+
+    else if (entry->atlas)
+    {
+        TextureCache_AddToAtlas(self, entry->atlas, fileName, surface);
+
+        entry->width = surface->w;
+        entry->height = surface->h;
+    }
+
+    else
+        TextureCache_Upload(self, entry, surface);
+
+    if (entry->atlas && LinkedList_GetSize(self->atlases) > 0)
+    {
+        for (LinkedListNode *iterator = LinkedList_GetFirst(self->atlases); iterator != NULL;)
+        {
+            if (LinkedList_GetValuePtr(self->atlases, iterator) == entry->atlas)
+            {
+                TextureCache_FinishAtlas(self, entry->atlas);
+                return;
+            }
+
+            LinkedList_Next(self->atlases, &iterator);
+        }
+    }
+}
+
+size_t TextureBytes(SDL_Texture *texture)
+{
+    Uint32 format;
+    int w, h;
+
+    if (SDL_QueryTexture(texture, &format, NULL, &w, &h) != 0)
+        return 0;
+
+    return (size_t)w * h * (SDL_BYTESPERPIXEL(format) ? SDL_BYTESPERPIXEL(format) : 4);
+}
+
+void DeleteEntry(TextureCacheEntry *entry)
+{
+    if (!entry->atlas)
+        SDL_DestroyTexture(entry->texture);
+
+    free(entry->fileName);
+    free(entry);
+}
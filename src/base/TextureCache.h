@@ -0,0 +1,73 @@
+//-------------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Fábio Pichler
+/*-------------------------------------------------------------------------------
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+-------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <SDL2/SDL.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Renderer-scoped cache of image textures, keyed by asset path.
+// Entries stay resident when their reference count drops to zero,
+// so they can be reused until TextureCache_Purge is called.
+// With an AssetLoader, images are decoded in the background and
+// TextureCache_GetTexture returns NULL until the upload has happened.
+// With a budget set, textures not drawn recently are evicted in
+// TextureCache_NextFrame and reloaded when TextureCache_Use sees them.
+// When the renderer shows fewer output pixels than logical ones, images
+// are uploaded as downscaled variants; GetSize keeps the logical size.
+// Atlas pages are packed again from their sources when that scale changes.
+// The generation changes whenever any entry's texture or rect does, so
+// holders of resolved draws know when to look the entry up again.
+
+typedef struct TextureCache TextureCache;
+typedef struct TextureCacheEntry TextureCacheEntry;
+typedef struct TextureAtlas TextureAtlas;
+typedef struct AssetLoader AssetLoader;
+
+TextureCache *TextureCache_New(SDL_Renderer *renderer, AssetLoader *loader);
+void TextureCache_Delete(TextureCache * const self);
+
+TextureCacheEntry *TextureCache_Acquire(TextureCache * const self, const char *fileName);
+void TextureCache_Release(TextureCache * const self, TextureCacheEntry *entry);
+void TextureCache_Purge(TextureCache * const self);
+void TextureCache_AddAtlasImage(TextureCache * const self, TextureAtlas *atlas, const char *fileName);
+void TextureCache_AddAtlas(TextureCache * const self, TextureAtlas *atlas);
+
+void TextureCache_SetBudget(TextureCache * const self, size_t bytes);
+size_t TextureCache_GetResidentBytes(TextureCache * const self);
+void TextureCache_NextFrame(TextureCache * const self);
+SDL_Texture *TextureCache_Use(TextureCache * const self, TextureCacheEntry *entry);
+void TextureCache_SetOutputScale(TextureCache * const self, float scale);
+Uint32 TextureCache_GetGeneration(TextureCache * const self);
+
+SDL_Texture *TextureCache_GetTexture(TextureCache * const self, TextureCacheEntry *entry);
+SDL_Rect TextureCache_GetRect(TextureCache * const self, TextureCacheEntry *entry);
+void TextureCache_GetSize(TextureCache * const self, TextureCacheEntry *entry, int *w, int *h);
+
+#ifdef __cplusplus
+}
+#endif
@@ -23,9 +23,7 @@ SOFTWARE.
 -------------------------------------------------------------------------------*/
 
 #include "Window.h"
-#include "DataZipFile.h"
-
-#include <SDL2/SDL_image.h>
+#include "ImageLoader.h"
 
 #include <stdio.h>
 
@@ -70,11 +68,7 @@ void Window_Delete(Window * const self)
 
 void Window_SetWindowIcon(Window * const self, const char *filename)
 {
-#ifdef USE_DATA_ZIP
-    SDL_Surface *surface = IMG_Load_RW(DataZipFile_Load_RW(filename), 1);
-#else
-    SDL_Surface *surface = IMG_Load(filename);
-#endif
+    SDL_Surface *surface = ImageLoader_Load(filename);
     SDL_SetWindowIcon(self->window, surface);
     SDL_FreeSurface(surface);
 }
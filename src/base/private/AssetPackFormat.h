@@ -0,0 +1,65 @@
+//-------------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Fábio Pichler
+/*-------------------------------------------------------------------------------
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+-------------------------------------------------------------------------------*/
+
+#pragma once
+
+// On-disk layout of the pack written by tools/asset-baker.c. All integers
+// are little-endian.
+//
+// Header (32 bytes)
+//   magic "MGPK", version, pixel format, entry count,
+//   hash slot count, entries offset, hash slots offset, names offset
+// Entry (32 bytes each)
+//   name offset, name length, type, width, height, pitch, data offset, data size
+// Hash slots (4 bytes each)
+//   entry index + 1, or 0 for an empty slot, probed linearly from
+//   AssetPack_Hash(name) & (slot count - 1)
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define ASSET_PACK_MAGIC "MGPK"
+#define ASSET_PACK_VERSION 1
+#define ASSET_PACK_HEADER_SIZE 32
+#define ASSET_PACK_ENTRY_SIZE 32
+#define ASSET_PACK_ALIGNMENT 16
+
+typedef enum AssetPack_EntryType
+{
+    AssetPack_Image = 0,
+    AssetPack_Raw = 1,
+} AssetPack_EntryType;
+
+static inline uint32_t AssetPack_Hash(const char *name, size_t length)
+{
+    uint32_t hash = 2166136261u;
+
+    for (size_t i = 0; i < length; ++i)
+    {
+        hash ^= (unsigned char)name[i];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
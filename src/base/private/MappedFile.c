@@ -0,0 +1,141 @@
+//-------------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Fábio Pichler
+/*-------------------------------------------------------------------------------
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+-------------------------------------------------------------------------------*/
+
+#include "MappedFile.h"
+
+#include <stdlib.h>
+
+#ifdef _WIN32
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+struct MappedFile
+{
+    const unsigned char *data;
+    size_t size;
+
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#endif
+};
+
+MappedFile *MappedFile_Open(const char *fileName)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if (file == INVALID_HANDLE_VALUE)
+        return NULL;
+
+    LARGE_INTEGER size;
+
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return NULL;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    const void *data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+
+    if (!data)
+    {
+        if (mapping)
+            CloseHandle(mapping);
+
+        CloseHandle(file);
+        return NULL;
+    }
+
+    MappedFile * const self = malloc(sizeof (MappedFile));
+
+    self->data = data;
+    self->size = (size_t)size.QuadPart;
+    self->file = file;
+    self->mapping = mapping;
+
+    return self;
+#else
+    const int fd = open(fileName, O_RDONLY);
+
+    if (fd < 0)
+        return NULL;
+
+    struct stat info;
+
+    if (fstat(fd, &info) != 0 || info.st_size == 0)
+    {
+        close(fd);
+        return NULL;
+    }
+
+    void *data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    // The mapping keeps its own reference to the file.
+    close(fd);
+
+    if (data == MAP_FAILED)
+        return NULL;
+
+    MappedFile * const self = malloc(sizeof (MappedFile));
+
+    self->data = data;
+    self->size = (size_t)info.st_size;
+
+    return self;
+#endif
+}
+
+void MappedFile_Close(MappedFile * const self)
+{
+    if (!self)
+        return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(self->data);
+    CloseHandle(self->mapping);
+    CloseHandle(self->file);
+#else
+    munmap((void *)self->data, self->size);
+#endif
+
+    free(self);
+}
+
+const unsigned char *MappedFile_Data(MappedFile * const self)
+{
+    return self->data;
+}
+
+size_t MappedFile_Size(MappedFile * const self)
+{
+    return self->size;
+}
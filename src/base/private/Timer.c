@@ -23,60 +23,66 @@ SOFTWARE.
 -------------------------------------------------------------------------------*/
 
 #include "Timer.h"
-#include "../LinkedList.h"
 #include "../SceneManager.h"
 
 #include <stdlib.h>
-
-#ifdef __EMSCRIPTEN__
-  #include <emscripten.h>
-#else
-  #include <SDL2/SDL_timer.h>
-#endif
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
 
 typedef struct TimerData
 {
     SceneManager_TimerCallback callback;
     void *userdata;
-
-#ifdef __EMSCRIPTEN__
     Uint64 time;
-#else
-    SDL_TimerID timerId;
-#endif
-
+    Uint32 sequence;
+    Uint32 generation;
+    int heapIndex;
+    int nextFree;
+    bool hasPayload;
+    _Alignas(max_align_t) unsigned char payload[SCENE_MANAGER_TIMER_PAYLOAD_SIZE];
 } TimerData;
 
-#ifndef __EMSCRIPTEN__
-static const int TimerEventCode = 42000;
-
-static Uint32 TimerCallback(Uint32 interval, void *param)
+// Due timers live in a binary min-heap of slot indices ordered by
+// (time, sequence), so equal deadlines fire in the order they were added.
+// Slots are recycled through a free list and both arrays only grow, so a
+// warmed-up scheduler never allocates. A handle is the slot index plus the
+// slot's generation, which changes on release, so stale handles miss.
+struct Timer
 {
-    (void)interval;
-
-    SDL_Event event = {.type = SDL_USEREVENT};
-    event.user = (SDL_UserEvent) {
-        .type = SDL_USEREVENT,
-        .code = TimerEventCode,
-        .data1 = param,
-    };
+    TimerData *slots;
+    int slotCount;
+    int freeSlot;
 
-    SDL_PushEvent(&event);
+    int *heap;
+    int heapCount;
+    int capacity;
 
-    return 0;
-}
-#endif
-
-struct Timer
-{
-    LinkedList *timers;
+    Uint32 sequence;
 };
 
+int Timer_AllocSlot(Timer * const self);
+Timer_Handle Timer_Schedule(Timer * const self, int slot, Uint32 interval, Timer_TimerCallback callback);
+TimerData *Timer_Find(Timer * const self, Timer_Handle handle);
+void Timer_RemoveAt(Timer * const self, int index);
+bool Timer_Less(Timer * const self, int a, int b);
+void Timer_Place(Timer * const self, int index, int slot);
+void Timer_SiftUp(Timer * const self, int index);
+void Timer_SiftDown(Timer * const self, int index);
+
 Timer *Timer_New()
 {
     Timer * const self = malloc(sizeof (Timer));
 
-    self->timers = LinkedList_New();
+    self->slots = NULL;
+    self->slotCount = 0;
+    self->freeSlot = -1;
+
+    self->heap = NULL;
+    self->heapCount = 0;
+    self->capacity = 0;
+
+    self->sequence = 0;
 
     return self;
 }
@@ -86,83 +92,228 @@ void Timer_Delete(Timer * const self)
     if (!self)
         return;
 
-    Timer_Clear(self);
-    LinkedList_Delete(self->timers);
-
+    free(self->slots);
+    free(self->heap);
     free(self);
 }
 
 void Timer_Clear(Timer * const self)
 {
-#ifndef __EMSCRIPTEN__
-    for (LinkedListNode *iterator = LinkedList_GetFirst(self->timers); iterator != NULL;)
+    while (self->heapCount > 0)
+        Timer_RemoveAt(self, self->heapCount - 1);
+}
+
+Timer_Handle Timer_Add(Timer * const self, Uint32 interval, Timer_TimerCallback callback, void *userdata)
+{
+    const int slot = Timer_AllocSlot(self);
+
+    self->slots[slot].userdata = userdata;
+    self->slots[slot].hasPayload = false;
+
+    return Timer_Schedule(self, slot, interval, callback);
+}
+
+Timer_Handle Timer_AddPayload(Timer * const self, Uint32 interval, Timer_TimerCallback callback,
+                              const void *payload, size_t size)
+{
+    if (size > SCENE_MANAGER_TIMER_PAYLOAD_SIZE)
+    {
+        printf("Timer payload of %zu bytes does not fit in a %d byte slot\n", size, SCENE_MANAGER_TIMER_PAYLOAD_SIZE);
+        return 0;
+    }
+
+    const int slot = Timer_AllocSlot(self);
+
+    memcpy(self->slots[slot].payload, payload, size);
+    self->slots[slot].userdata = NULL;
+    self->slots[slot].hasPayload = true;
+
+    return Timer_Schedule(self, slot, interval, callback);
+}
+
+bool Timer_Cancel(Timer * const self, Timer_Handle handle)
+{
+    TimerData *data = Timer_Find(self, handle);
+
+    if (!data)
+        return false;
+
+    Timer_RemoveAt(self, data->heapIndex);
+
+    return true;
+}
+
+bool Timer_Reschedule(Timer * const self, Timer_Handle handle, Uint32 interval)
+{
+    TimerData *data = Timer_Find(self, handle);
+
+    if (!data)
+        return false;
+
+    // Requeued behind timers that already share the new deadline.
+    data->time = SDL_GetTicks64() + interval;
+    data->sequence = self->sequence++;
+
+    const int slot = self->heap[data->heapIndex];
+
+    Timer_SiftDown(self, data->heapIndex);
+    Timer_SiftUp(self, self->slots[slot].heapIndex);
+
+    return true;
+}
+
+void Timer_Update(Timer * const self, SceneManager *sceneManager)
+{
+    const Uint64 now = SDL_GetTicks64();
+
+    while (self->heapCount > 0 && self->slots[self->heap[0]].time <= now)
     {
-        TimerData *data = LinkedList_GetValuePtr(self->timers, iterator);
+        // Copied and released before the call, the callback may add or clear timers.
+        // An inline payload is handed over from the copy, valid until the callback returns.
+        TimerData data = self->slots[self->heap[0]];
 
-        SDL_RemoveTimer(data->timerId);
-        free(data);
-        LinkedList_Next(self->timers, &iterator);
+        Timer_RemoveAt(self, 0);
+        data.callback(sceneManager, data.hasPayload ? data.payload : data.userdata);
     }
-#endif
+}
+
+Sint32 Timer_GetTimeout(Timer * const self)
+{
+    if (self->heapCount == 0)
+        return -1;
+
+    const Uint64 now = SDL_GetTicks64();
+    const Uint64 time = self->slots[self->heap[0]].time;
 
-    LinkedList_Clear(self->timers);
+    return time > now ? (Sint32)SDL_min(time - now, SDL_MAX_SINT32) : 0;
 }
 
-void Timer_Add(Timer * const self, Uint32 interval, Timer_TimerCallback callback, void *userdata)
+int Timer_AllocSlot(Timer * const self)
 {
-    TimerData *data = malloc(sizeof (TimerData));
+    if (self->freeSlot >= 0)
+    {
+        const int slot = self->freeSlot;
 
-    data->callback = callback;
-    data->userdata = userdata;
+        self->freeSlot = self->slots[slot].nextFree;
+        return slot;
+    }
+
+    if (self->slotCount == self->capacity)
+    {
+        self->capacity = self->capacity ? self->capacity * 2 : 16;
+        self->slots = realloc(self->slots, sizeof (TimerData) * self->capacity);
+        self->heap = realloc(self->heap, sizeof (int) * self->capacity);
+    }
+
+    self->slots[self->slotCount].generation = 1;
 
-#ifdef __EMSCRIPTEN__
+    return self->slotCount++;
+}
+
+Timer_Handle Timer_Schedule(Timer * const self, int slot, Uint32 interval, Timer_TimerCallback callback)
+{
+    TimerData *data = &self->slots[slot];
+
+    data->callback = callback;
     data->time = SDL_GetTicks64() + interval;
+    data->sequence = self->sequence++;
+
+    Timer_Place(self, self->heapCount++, slot);
+    Timer_SiftUp(self, data->heapIndex);
+
+    return (Timer_Handle)data->generation << 32 | (Uint32)slot;
+}
+
+TimerData *Timer_Find(Timer * const self, Timer_Handle handle)
+{
+    const Uint32 slot = (Uint32)handle;
+
+    if (handle == 0 || slot >= (Uint32)self->slotCount)
+        return NULL;
 
-    LinkedList_PushPtr(self->timers, data);
-#else
-    data->timerId = SDL_AddTimer(interval, TimerCallback, data);
+    TimerData *data = &self->slots[slot];
 
-    LinkedList_PushPtr(self->timers, data);
-#endif
+    if (data->generation != (Uint32)(handle >> 32) || data->heapIndex < 0)
+        return NULL;
+
+    return data;
 }
 
-void Timer_ProcessEvent(Timer * const self, SceneManager *sceneManager, SDL_Event *event)
+void Timer_RemoveAt(Timer * const self, int index)
 {
-#ifndef __EMSCRIPTEN__
-    if (event->type == SDL_USEREVENT && event->user.type == SDL_USEREVENT)
+    const int slot = self->heap[index];
+    const int last = self->heap[--self->heapCount];
+
+    if (index < self->heapCount)
     {
-        if (event->user.code == TimerEventCode)
-        {
-            TimerData *data = event->user.data1;
+        Timer_Place(self, index, last);
+        Timer_SiftDown(self, index);
+        Timer_SiftUp(self, self->slots[last].heapIndex);
+    }
+
+    // Zero is never a valid handle, so the generation skips it when it wraps.
+    self->slots[slot].heapIndex = -1;
+    self->slots[slot].generation = self->slots[slot].generation + 1 ? self->slots[slot].generation + 1 : 1;
+    self->slots[slot].nextFree = self->freeSlot;
+    self->freeSlot = slot;
+}
+
+bool Timer_Less(Timer * const self, int a, int b)
+{
+    const TimerData *x = &self->slots[self->heap[a]];
+    const TimerData *y = &self->slots[self->heap[b]];
+
+    if (x->time != y->time)
+        return x->time < y->time;
+
+    // Wrap-safe, a sequence only competes with timers added around the same time.
+    return (Sint32)(x->sequence - y->sequence) < 0;
+}
 
-            data->callback(sceneManager, data->userdata);
+void Timer_Place(Timer * const self, int index, int slot)
+{
+    self->heap[index] = slot;
+    self->slots[slot].heapIndex = index;
+}
 
-            SDL_RemoveTimer(data->timerId);
-            LinkedList_RemoveFromValuePtr(self->timers, data);
-            free(data);
-        }
+void Timer_SiftUp(Timer * const self, int index)
+{
+    while (index > 0)
+    {
+        const int parent = (index - 1) / 2;
+
+        if (!Timer_Less(self, index, parent))
+            break;
+
+        const int slot = self->heap[index];
+
+        Timer_Place(self, index, self->heap[parent]);
+        Timer_Place(self, parent, slot);
+        index = parent;
     }
-#endif
 }
 
-void Timer_Update(Timer * const self, SceneManager *sceneManager)
+void Timer_SiftDown(Timer * const self, int index)
 {
-#ifdef __EMSCRIPTEN__
-    for (LinkedListNode *iterator = LinkedList_GetFirst(self->timers); iterator != NULL;)
+    while (1)
     {
-        TimerData *data = LinkedList_GetValuePtr(self->timers, iterator);
-
-        if (SDL_GetTicks64() >= data->time)
-        {
-            data->callback(sceneManager, data->userdata);
-
-            free(data);
-            LinkedList_Remove(self->timers, &iterator);
-        }
-        else
-        {
-            LinkedList_Next(self->timers, &iterator);
-        }
+        const int left = index * 2 + 1;
+        const int right = left + 1;
+        int smallest = index;
+
+        if (left < self->heapCount && Timer_Less(self, left, smallest))
+            smallest = left;
+
+        if (right < self->heapCount && Timer_Less(self, right, smallest))
+            smallest = right;
+
+        if (smallest == index)
+            break;
+
+        const int slot = self->heap[index];
+
+        Timer_Place(self, index, self->heap[smallest]);
+        Timer_Place(self, smallest, slot);
+        index = smallest;
     }
-#endif
 }
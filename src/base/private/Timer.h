@@ -26,17 +26,23 @@ SOFTWARE.
 
 #include <SDL2/SDL.h>
 #include <stdint.h>
+#include <stdbool.h>
 
 typedef struct SceneManager SceneManager;
 
 typedef struct Timer Timer;
 
+typedef Uint64 Timer_Handle;
 typedef void (*Timer_TimerCallback)(void * const manager, void *userdata);
 
 Timer *Timer_New();
 void Timer_Delete(Timer * const self);
 
 void Timer_Clear(Timer * const self);
-void Timer_Add(Timer * const self, Uint32 interval, Timer_TimerCallback callback, void *userdata);
-void Timer_ProcessEvent(Timer * const self, SceneManager *sceneManager, SDL_Event *event);
+Timer_Handle Timer_Add(Timer * const self, Uint32 interval, Timer_TimerCallback callback, void *userdata);
+Timer_Handle Timer_AddPayload(Timer * const self, Uint32 interval, Timer_TimerCallback callback,
+                              const void *payload, size_t size);
+bool Timer_Cancel(Timer * const self, Timer_Handle handle);
+bool Timer_Reschedule(Timer * const self, Timer_Handle handle, Uint32 interval);
 void Timer_Update(Timer * const self, SceneManager *sceneManager);
+Sint32 Timer_GetTimeout(Timer * const self);
@@ -26,26 +26,30 @@ SOFTWARE.
 #include "../base/Button.h"
 #include "../base/Texture.h"
 #include "../base/Box.h"
+#include "../base/Layer.h"
+#include "../base/DisplayList.h"
 
 #include <malloc.h>
 
 struct Footer
 {
-    SDL_Renderer *renderer;
+    Graphics *graphics;
     SceneGameRect *sceneGameRect;
 
     Button *restartButton;
     Texture *copyrightText;
+    Layer *copyrightLayer;
 };
 
 void Footer_CreateRestartButton(Footer * const self);
 void Footer_CreateCopyrightText(Footer * const self);
+static void DrawCopyright(void *userdata);
 
-Footer *Footer_New(SDL_Renderer *renderer, SceneGameRect *sceneGameRect)
+Footer *Footer_New(Graphics *graphics, SceneGameRect *sceneGameRect)
 {
     Footer * const self = malloc(sizeof (Footer));
 
-    self->renderer = renderer;
+    self->graphics = graphics;
     self->sceneGameRect = sceneGameRect;
 
     Footer_CreateRestartButton(self);
@@ -61,6 +65,7 @@ void Footer_Delete(Footer * const self)
 
     Button_Delete(self->restartButton);
     Texture_Delete(self->copyrightText);
+    Layer_Delete(self->copyrightLayer);
 
     free(self);
 }
@@ -70,10 +75,10 @@ void Footer_ProcessEvent(Footer * const self, const SDL_Event *event)
     Button_ProcessEvent(self->restartButton, event);
 }
 
-void Footer_Draw(Footer * const self)
+void Footer_AddToDisplayList(Footer * const self, DisplayList *displayList)
 {
-    Button_Draw(self->restartButton);
-    Texture_Draw(self->copyrightText);
+    Button_AddToDisplayList(self->restartButton, displayList);
+    DisplayList_AddCallback(displayList, DrawCopyright, self);
 }
 
 Button *Footer_GetRestartButton(Footer * const self)
@@ -83,7 +88,7 @@ Button *Footer_GetRestartButton(Footer * const self)
 
 void Footer_CreateRestartButton(Footer * const self)
 {
-    self->restartButton = Button_New(self->renderer);
+    self->restartButton = Button_New(self->graphics);
 
     Button_SetText(self->restartButton, "Reiniciar", 16);
 
@@ -102,7 +107,7 @@ void Footer_CreateRestartButton(Footer * const self)
 
 void Footer_CreateCopyrightText(Footer * const self)
 {
-    self->copyrightText = Texture_New(self->renderer);
+    self->copyrightText = Texture_New(self->graphics);
 
     Texture_SetText(self->copyrightText, "© 2022 Fábio Pichler | www.fabiopichler.net");
     Texture_SetTextSize(self->copyrightText, 14);
@@ -117,4 +122,19 @@ void Footer_CreateCopyrightText(Footer * const self)
     Box_SetPosition(Texture_Box(self->copyrightText),
                     self->sceneGameRect->sidebar_w + ((self->sceneGameRect->content_w - width) / 2),
                     self->sceneGameRect->window_h - height - padding);
+
+    self->copyrightLayer = Layer_New(self->graphics, *Box_Rect(Texture_Box(self->copyrightText)));
+}
+
+void DrawCopyright(void *userdata)
+{
+    Footer * const self = userdata;
+
+    if (Layer_Begin(self->copyrightLayer))
+    {
+        Texture_Draw(self->copyrightText);
+        Layer_End(self->copyrightLayer);
+    }
+
+    Layer_Draw(self->copyrightLayer);
 }
@@ -30,9 +30,11 @@ SOFTWARE.
 #include <SDL2/SDL.h>
 
 typedef struct Footer Footer;
+typedef struct DisplayList DisplayList;
+typedef struct Graphics Graphics;
 
-Footer *Footer_New(SDL_Renderer *renderer, SceneGameRect *sceneGameRect);
+Footer *Footer_New(Graphics *graphics, SceneGameRect *sceneGameRect);
 void Footer_Delete(Footer * const self);
 void Footer_ProcessEvent(Footer * const self, const SDL_Event *event);
-void Footer_Draw(Footer * const self);
+void Footer_AddToDisplayList(Footer * const self, DisplayList *displayList);
 Button *Footer_GetRestartButton(Footer * const self);
@@ -24,15 +24,19 @@ SOFTWARE.
 
 #include "GameBoard.h"
 #include "../base/SceneManager.h"
+#include "../base/Graphics.h"
 #include "../base/Button.h"
 #include "../base/Texture.h"
+#include "../base/TextureCache.h"
 #include "../base/Rectangle.h"
 #include "../base/Box.h"
+#include "../base/DisplayList.h"
 
 #include <stdlib.h>
 
 #define ROWS 4
 #define COLS 8
+#define IMAGE_SIZE 72
 
 typedef struct GameEvent
 {
@@ -75,7 +79,8 @@ typedef struct TimerData
 struct GameBoard
 {
     SceneManager *sceneManager;
-    SDL_Renderer *renderer;
+    Graphics *graphics;
+    TextureCache *textureCache;
     Rectangle *background;
 
     Player player;
@@ -97,9 +102,12 @@ struct GameBoard
     } board;
 
     GameEvent gameEvent;
+    SceneManager_TimerHandle timer;
 };
 
 void GameBoard_SetupBoard(GameBoard * const self);
+void GameBoard_LoadItemTexture(GameBoard * const self, BoardItem *item);
+void GameBoard_Prefetch(GameBoard * const self, int x, int y);
 void GameBoard_OnItemPress(Button * const button, void *user);
 void GameBoard_CallEventFunction(GameBoard * const self);
 void GameBoard_FinalizeEventCallback(GameBoard * const self);
@@ -112,6 +120,7 @@ void GameBoard_UnblockEvents(GameBoard * const self);
 
 static void GetTimerData(void *userdata, GameBoard ** self, BoardItem **last_item, BoardItem **current_item);
 static BoardItem *GetItem(BoardItem items[ROWS][COLS], int id);
+static const char *GetImageFile(int image_id);
 static void SetupColors_Empty(Button *button);
 static void SetupColors_FirstItemSelected(Button *current_button);
 static void SetupColors_Correct(Button *last_button, Button *current_button);
@@ -119,7 +128,7 @@ static void SetupColors_CorrectAfterTimer(Button *last_button, Button *current_b
 static void SetupColors_Wrong(Button *last_button, Button *current_button);
 static void SetupColors_WrongAfterTimer(Button *last_button, Button *current_button);
 
-GameBoard *GameBoard_New(SDL_Renderer *renderer, SceneGameRect *sceneGameRect, SceneManager *sceneManager)
+GameBoard *GameBoard_New(Graphics *graphics, SceneGameRect *sceneGameRect, SceneManager *sceneManager)
 {
     GameBoard * const self = malloc(sizeof (GameBoard));
 
@@ -133,11 +142,13 @@ GameBoard *GameBoard_New(SDL_Renderer *renderer, SceneGameRect *sceneGameRect, S
     self->board.rect = (SDL_Rect) {board_x, board_y, board_size_x, board_size_y};
 
     self->sceneManager = sceneManager;
-    self->renderer = renderer;
-    self->background = Rectangle_New(self->renderer, board_size_x, board_size_y);
+    self->graphics = graphics;
+    self->textureCache = Graphics_GetTextureCache(graphics);
+    self->background = Rectangle_New(self->graphics, board_size_x, board_size_y);
     self->player = Player_1;
     self->gameResult = None;
     self->round = 0;
+    self->timer = 0;
     self->gameEvent = (GameEvent) {NULL, NULL};
 
     self->blockedEvents = false;
@@ -160,6 +171,9 @@ void GameBoard_Delete(GameBoard * const self)
     if (!self)
         return;
 
+    // A pending match result would otherwise fire into a freed board.
+    SceneManager_CancelTimer(self->sceneManager, self->timer);
+
     for (int row = 0; row < ROWS; ++row)
     {
         for (int col = 0; col < COLS; ++col)
@@ -178,6 +192,12 @@ void GameBoard_Delete(GameBoard * const self)
 
 void GameBoard_ProcessEvent(GameBoard * const self, const SDL_Event *event)
 {
+#ifdef LAZY_CARD_TEXTURES
+    // The second card of a pair is usually the one under the pointer.
+    if (event->type == SDL_MOUSEMOTION && self->lastImageId != 0)
+        GameBoard_Prefetch(self, event->motion.x, event->motion.y);
+#endif
+
     for (int row = 0; row < ROWS; ++row)
         for (int col = 0; col < COLS; ++col)
             Button_ProcessEvent(self->board.items[row][col].button, event);
@@ -187,13 +207,18 @@ void GameBoard_Update(GameBoard * const self, double deltaTime)
 {
 }
 
-void GameBoard_Draw(GameBoard * const self)
+void GameBoard_AddToDisplayList(GameBoard * const self, DisplayList *displayList)
 {
-    Rectangle_Draw(self->background);
+    const int layer = DisplayList_GetLayer(displayList);
+
+    Rectangle_AddToDisplayList(self->background, displayList);
+    DisplayList_SetLayer(displayList, layer + 1);
 
     for (int row = 0; row < ROWS; ++row)
         for (int col = 0; col < COLS; ++col)
-            Button_Draw(self->board.items[row][col].button);
+            Button_AddToDisplayList(self->board.items[row][col].button, displayList);
+
+    DisplayList_SetLayer(displayList, layer);
 }
 
 void GameBoard_SetGameEvent(GameBoard * const self, GameEventHandler callback, void *user)
@@ -222,6 +247,18 @@ int GameBoard_GetGameResult(GameBoard * const self)
     return self->gameResult;
 }
 
+void GameBoard_AddImagesToAtlas(TextureCache *cache, TextureAtlas *atlas)
+{
+#ifdef LAZY_CARD_TEXTURES
+    // Card images are only loaded once revealed.
+    (void)cache;
+    (void)atlas;
+#else
+    for (size_t i = 0; i < sizeof (images) / sizeof (images[0]); ++i)
+        TextureCache_AddAtlasImage(cache, atlas, images[i].image);
+#endif
+}
+
 static void shuffle(const Images **array, size_t n)
 {
     if (n < 1)
@@ -260,13 +297,15 @@ void GameBoard_SetupBoard(GameBoard * const self)
 
             *item = (BoardItem) {
                 .player = 0,
-                .button = Button_New(self->renderer),
-                .texture = Texture_New(self->renderer),
+                .button = Button_New(self->graphics),
+                .texture = NULL,
                 .id = i,
                 .image_id = image->id,
             };
 
-            Texture_LoadImageFromFile(item->texture, image->image);
+#ifndef LAZY_CARD_TEXTURES
+            GameBoard_LoadItemTexture(self, item);
+#endif
 
             Box_SetSize(Button_Box(item->button), self->board.item_size, self->board.item_size);
             Box_SetPosition(Button_Box(item->button),
@@ -279,6 +318,32 @@ void GameBoard_SetupBoard(GameBoard * const self)
     }
 }
 
+void GameBoard_LoadItemTexture(GameBoard * const self, BoardItem *item)
+{
+    if (item->texture)
+        return;
+
+    item->texture = Texture_New(self->graphics);
+
+    Texture_SetPlaceholderSize(item->texture, IMAGE_SIZE, IMAGE_SIZE);
+    Texture_LoadImageFromCache(item->texture, self->textureCache, GetImageFile(item->image_id));
+}
+
+void GameBoard_Prefetch(GameBoard * const self, int x, int y)
+{
+    const int cell = self->board.item_size + self->board.space;
+    const int col = (x - self->board.rect.x) / cell;
+    const int row = (y - self->board.rect.y) / cell;
+
+    if (x < self->board.rect.x || y < self->board.rect.y || col >= COLS || row >= ROWS)
+        return;
+
+    BoardItem *item = &self->board.items[row][col];
+
+    if (item->player == None)
+        GameBoard_LoadItemTexture(self, item);
+}
+
 void GameBoard_OnItemPress(Button * const button, void *user)
 {
     GameBoard * const self = user;
@@ -369,6 +434,7 @@ void GameBoard_Check(GameBoard * const self, BoardItem *current_item)
         self->lastItemId = current_item->id;
         self->lastImageId = current_item->image_id;
 
+        GameBoard_LoadItemTexture(self, current_item);
         Button_SetIcon(current_item->button, current_item->texture);
         SetupColors_FirstItemSelected(current_item->button);
         GameBoard_UnblockEvents(self);
@@ -381,6 +447,8 @@ void GameBoard_Check(GameBoard * const self, BoardItem *current_item)
     if (current_item->player != None || current_item->id == last_item->id)
         return GameBoard_UnblockEvents(self);
 
+    GameBoard_LoadItemTexture(self, current_item);
+
     if (self->lastImageId == current_item->image_id)
     {
         Button_SetIcon(current_item->button, current_item->texture);
@@ -417,13 +485,9 @@ void GameBoard_CheckWinner(GameBoard * const self)
 void GameBoard_AddTimer(GameBoard * const self, Uint32 interval, BoardItem *last_item, BoardItem *current_item,
                         SceneManager_TimerCallback callback)
 {
-    TimerData *data = malloc(sizeof (TimerData));
+    const TimerData data = {self, last_item, current_item};
 
-    data->self = self;
-    data->last_item = last_item;
-    data->current_item = current_item;
-
-    SceneManager_AddTimer(self->sceneManager, interval, callback, data);
+    self->timer = SceneManager_AddTimerPayload(self->sceneManager, interval, callback, &data, sizeof (data));
 }
 
 void GetTimerData(void *userdata, GameBoard **self, BoardItem **last_item, BoardItem **current_item)
@@ -433,8 +497,6 @@ void GetTimerData(void *userdata, GameBoard **self, BoardItem **last_item, Board
     *self = data->self;
     *last_item = data->last_item;
     *current_item = data->current_item;
-
-    free(data);
 }
 
 BoardItem *GetItem(BoardItem items[ROWS][COLS], int id)
@@ -453,6 +515,15 @@ BoardItem *GetItem(BoardItem items[ROWS][COLS], int id)
     return NULL;
 }
 
+const char *GetImageFile(int image_id)
+{
+    for (size_t i = 0; i < sizeof (images) / sizeof (images[0]); ++i)
+        if (images[i].id == image_id)
+            return images[i].image;
+
+    return NULL;
+}
+
 void GameBoard_BlockEvents(GameBoard * const self)
 {
     self->blockedEvents = true;
@@ -31,6 +31,10 @@ SOFTWARE.
 typedef struct Button Button;
 typedef struct Texture Texture;
 typedef struct SceneManager SceneManager;
+typedef struct TextureAtlas TextureAtlas;
+typedef struct TextureCache TextureCache;
+typedef struct DisplayList DisplayList;
+typedef struct Graphics Graphics;
 
 typedef struct GameBoard GameBoard;
 
@@ -53,13 +57,14 @@ typedef struct BoardItem
     int image_id;
 } BoardItem;
 
-GameBoard *GameBoard_New(SDL_Renderer *renderer, SceneGameRect *sceneGameRect, SceneManager *sceneManager);
+GameBoard *GameBoard_New(Graphics *graphics, SceneGameRect *sceneGameRect, SceneManager *sceneManager);
 void GameBoard_Delete(GameBoard * const self);
 void GameBoard_ProcessEvent(GameBoard * const self, const SDL_Event *event);
 void GameBoard_Update(GameBoard * const self, double deltaTime);
-void GameBoard_Draw(GameBoard * const self);
+void GameBoard_AddToDisplayList(GameBoard * const self, DisplayList *displayList);
 void GameBoard_SetGameEvent(GameBoard * const self, GameEventHandler callback, void *user);
 int GameBoard_GetCurrentPlayer(GameBoard * const self);
 int GameBoard_GetPlayer1Count(GameBoard * const self);
 int GameBoard_GetPlayer2Count(GameBoard * const self);
 int GameBoard_GetGameResult(GameBoard * const self);
+void GameBoard_AddImagesToAtlas(TextureCache *cache, TextureAtlas *atlas);
@@ -26,6 +26,8 @@ SOFTWARE.
 #include "../base/Texture.h"
 #include "../base/Rectangle.h"
 #include "../base/Box.h"
+#include "../base/DisplayList.h"
+#include "../base/Damage.h"
 #include "GameBoard.h"
 
 #include <malloc.h>
@@ -37,8 +39,10 @@ struct Header
     int margin;
     float line_p1_x;
     float line_p2_x;
+    float lineX;
+    float previousLineX;
 
-    SDL_Renderer *renderer;
+    Graphics *graphics;
     SceneGameRect *sceneGameRect;
 
     Rectangle *background1;
@@ -51,6 +55,10 @@ struct Header
     Texture *result;
     Texture *player1;
     Texture *player2;
+
+    DisplayList *displayList;
+    int playingNodes[3];
+    int resultNodes[3];
 };
 
 void Header_CreateBackgrounds(Header * const self);
@@ -60,8 +68,9 @@ void Header_CreatePlayer2Text(Header * const self);
 void Header_SetupResultText(Header * const self);
 void Header_SetupPlayer1Text(Header * const self);
 void Header_SetupPlayer2Text(Header * const self);
+void Header_UpdateVisibility(Header * const self);
 
-Header *Header_New(SDL_Renderer *renderer, SceneGameRect *sceneGameRect)
+Header *Header_New(Graphics *graphics, SceneGameRect *sceneGameRect)
 {
     Header * const self = malloc(sizeof (Header));
 
@@ -73,13 +82,17 @@ Header *Header_New(SDL_Renderer *renderer, SceneGameRect *sceneGameRect)
     self->line_p1_x = x - 75.f;
     self->line_p2_x = x + 75.f;
 
-    self->renderer = renderer;
+    self->graphics = graphics;
     self->sceneGameRect = sceneGameRect;
     self->currentPlayer = Player_1;
     self->gameResult = None;
+    self->displayList = NULL;
+
+    self->lineX = self->line_p1_x;
+    self->previousLineX = self->line_p1_x;
 
-    self->line = Rectangle_New(self->renderer, w, 4.f);
-    Box_SetPosition(Rectangle_Box(self->line), self->line_p1_x, 62.f);
+    self->line = Rectangle_New(self->graphics, w, 4.f);
+    Box_SetPosition(Rectangle_Box(self->line), self->lineX, 62.f);
     Rectangle_SetColorRGBA(self->line, 80, 150, 220, 255);
 
     Header_CreateBackgrounds(self);
@@ -113,32 +126,43 @@ void Header_ProcessEvent(Header * const self, const SDL_Event *event)
 
 void Header_Update(Header * const self, double deltaTime)
 {
-    Box * const lineBox = Rectangle_Box(self->line);
-    const float x = Box_X(lineBox);
+    const float x = self->lineX;
+
+    self->previousLineX = x;
 
     if (self->currentPlayer == Player_1 && x >= self->line_p1_x)
-        Box_SetX(lineBox, fmax(x - (800.0 * deltaTime), self->line_p1_x));
+        self->lineX = fmax(x - (800.0 * deltaTime), self->line_p1_x);
 
     else if (self->currentPlayer == Player_2 && x <= self->line_p2_x)
-        Box_SetX(lineBox, fmin(x + (800.0 * deltaTime), self->line_p2_x));
+        self->lineX = fmin(x + (800.0 * deltaTime), self->line_p2_x);
+
+    // The box only moves when drawing, so a moving line has to ask for the frame itself.
+    if (self->lineX != x)
+        Damage_Invalidate();
 }
 
-void Header_Draw(Header * const self)
+void Header_Interpolate(Header * const self, double alpha)
 {
-    if (self->gameResult == None)
-    {
-        Rectangle_Draw(self->line);
+    Box_SetX(Rectangle_Box(self->line), self->previousLineX + (self->lineX - self->previousLineX) * alpha);
+}
 
-        Texture_Draw(self->player1);
-        Texture_Draw(self->player2);
-    }
-    else
-    {
-        Rectangle_Draw(self->background1);
-        Rectangle_Draw(self->background2);
+void Header_AddToDisplayList(Header * const self, DisplayList *displayList)
+{
+    const int layer = DisplayList_GetLayer(displayList);
 
-        Texture_Draw(self->result);
-    }
+    self->displayList = displayList;
+
+    self->playingNodes[0] = Rectangle_AddToDisplayList(self->line, displayList);
+    self->resultNodes[0] = Rectangle_AddToDisplayList(self->background1, displayList);
+    self->resultNodes[1] = Rectangle_AddToDisplayList(self->background2, displayList);
+
+    DisplayList_SetLayer(displayList, layer + 1);
+    self->playingNodes[1] = DisplayList_AddTexture(displayList, &self->player1);
+    self->playingNodes[2] = DisplayList_AddTexture(displayList, &self->player2);
+    self->resultNodes[2] = DisplayList_AddTexture(displayList, &self->result);
+    DisplayList_SetLayer(displayList, layer);
+
+    Header_UpdateVisibility(self);
 }
 
 void Header_SetCurrentPlayer(Header * const self, Player currentPlayer, Player gameResult)
@@ -146,6 +170,8 @@ void Header_SetCurrentPlayer(Header * const self, Player currentPlayer, Player g
     self->currentPlayer = currentPlayer;
     self->gameResult = gameResult;
 
+    Header_UpdateVisibility(self);
+
     if (self->gameResult == Player_1)
         Texture_SetText(self->result, "Vitória do jogador 1");
 
@@ -164,7 +190,7 @@ void Header_SetCurrentPlayer(Header * const self, Player currentPlayer, Player g
 
 void Header_CreateResultText(Header * const self)
 {
-    self->result = Texture_New(self->renderer);
+    self->result = Texture_New(self->graphics);
 
     Texture_SetText(self->result, "...");
     Texture_SetTextSize(self->result, 24);
@@ -180,20 +206,20 @@ void Header_CreateBackgrounds(Header * const self)
     int x = self->sceneGameRect->sidebar_w + ((self->sceneGameRect->content_w - w) / 2);
     int y = 18;
 
-    self->background1 = Rectangle_New(self->renderer, w, h);
+    self->background1 = Rectangle_New(self->graphics, w, h);
     Box_SetPosition(Rectangle_Box(self->background1), x, y);
     Rectangle_SetColorRGBA(self->background1, 80, 150, 220, 255);
 
     w -= 2; h -= 2; x -= 2; y -= 2;
 
-    self->background2 = Rectangle_New(self->renderer, w, h);
+    self->background2 = Rectangle_New(self->graphics, w, h);
     Box_SetPosition(Rectangle_Box(self->background2), x, y);
     Rectangle_SetColorRGBA(self->background2, 220, 240, 255, 255);
 }
 
 void Header_CreatePlayer1Text(Header * const self)
 {
-    self->player1 = Texture_New(self->renderer);
+    self->player1 = Texture_New(self->graphics);
 
     Texture_SetText(self->player1, "Jogador 1");
     Texture_SetTextSize(self->player1, 20);
@@ -205,7 +231,7 @@ void Header_CreatePlayer1Text(Header * const self)
 
 void Header_CreatePlayer2Text(Header * const self)
 {
-    self->player2 = Texture_New(self->renderer);
+    self->player2 = Texture_New(self->graphics);
 
     Texture_SetText(self->player2, "Jogador 2");
     Texture_SetTextSize(self->player2, 20);
@@ -245,3 +271,15 @@ void Header_SetupPlayer2Text(Header * const self)
     Box_SetSize(Texture_Box(self->player2), text_w, text_h);
     Box_SetPosition(Texture_Box(self->player2), text_x, 30);
 }
+
+void Header_UpdateVisibility(Header * const self)
+{
+    if (!self->displayList)
+        return;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        DisplayList_SetVisible(self->displayList, self->playingNodes[i], self->gameResult == None);
+        DisplayList_SetVisible(self->displayList, self->resultNodes[i], self->gameResult != None);
+    }
+}
@@ -31,10 +31,13 @@ SOFTWARE.
 typedef enum Player Player;
 
 typedef struct Header Header;
+typedef struct DisplayList DisplayList;
+typedef struct Graphics Graphics;
 
-Header *Header_New(SDL_Renderer *renderer, SceneGameRect *sceneGameRect);
+Header *Header_New(Graphics *graphics, SceneGameRect *sceneGameRect);
 void Header_Delete(Header * const self);
 void Header_ProcessEvent(Header * const self, const SDL_Event *event);
 void Header_Update(Header * const self, double deltaTime);
-void Header_Draw(Header * const self);
+void Header_Interpolate(Header * const self, double alpha);
+void Header_AddToDisplayList(Header * const self, DisplayList *displayList);
 void Header_SetCurrentPlayer(Header * const self, Player currentPlayer, Player gameResult);
@@ -31,6 +31,7 @@ SOFTWARE.
 #include "../base/Button.h"
 #include "../base/Texture.h"
 #include "../base/Rectangle.h"
+#include "../base/DisplayList.h"
 #include "Sidebar.h"
 #include "Header.h"
 #include "Footer.h"
@@ -40,7 +41,7 @@ SOFTWARE.
 struct SceneGame
 {
     SceneManager *sceneManager;
-    SDL_Renderer *renderer;
+    Graphics *graphics;
     SceneGameRect sceneGameRect;
 
     int player1WinCount;
@@ -52,9 +53,12 @@ struct SceneGame
     Sidebar *sidebar;
     Header *header;
     Footer *footer;
+
+    DisplayList *displayList;
 };
 
 void SceneGame_NewGame(SceneGame * const self);
+void SceneGame_BuildDisplayList(SceneGame * const self);
 void SceneGame_OnPressed(Button * const button, void *user);
 void SceneGame_OnGameEvent(GameBoard * const game, void *user);
 
@@ -74,17 +78,18 @@ SceneGame *SceneGame_OnNew(SceneManager *sceneManager)
     self->sceneGameRect.content_h = windowRect.h;
 
     self->sceneManager = sceneManager;
-    self->renderer = Graphics_GetRenderer(graphics);
+    self->graphics = graphics;
 
     self->player1WinCount = 0;
     self->player2WinCount = 0;
     self->tiedCount = 0;
 
-    self->background = Rectangle_New(self->renderer, self->sceneGameRect.window_w, self->sceneGameRect.window_h);
+    self->background = Rectangle_New(self->graphics, self->sceneGameRect.window_w, self->sceneGameRect.window_h);
     self->gameBoard = NULL;
-    self->sidebar = Sidebar_New(self->renderer, &self->sceneGameRect);
-    self->header = Header_New(self->renderer, &self->sceneGameRect);
-    self->footer = Footer_New(self->renderer, &self->sceneGameRect);
+    self->sidebar = Sidebar_New(self->graphics, &self->sceneGameRect);
+    self->header = Header_New(self->graphics, &self->sceneGameRect);
+    self->footer = Footer_New(self->graphics, &self->sceneGameRect);
+    self->displayList = DisplayList_New(self->graphics);
 
     Rectangle_SetColorRGBA(self->background, 225, 225, 225, 255);
 
@@ -106,6 +111,7 @@ void SceneGame_OnDelete(SceneGame * const self)
     Header_Delete(self->header);
     Sidebar_Delete(self->sidebar);
     Rectangle_Delete(self->background);
+    DisplayList_Delete(self->displayList);
 
     free(self);
 }
@@ -123,24 +129,38 @@ void SceneGame_OnUpdate(SceneGame * const self, double deltaTime)
     GameBoard_Update(self->gameBoard, deltaTime);
 }
 
-void SceneGame_OnDraw(SceneGame * const self)
+void SceneGame_OnDraw(SceneGame * const self, double alpha)
 {
-    Rectangle_Draw(self->background);
-    GameBoard_Draw(self->gameBoard);
-    Header_Draw(self->header);
-    Footer_Draw(self->footer);
-    Sidebar_Draw(self->sidebar);
+    Header_Interpolate(self->header, alpha);
+    DisplayList_Draw(self->displayList);
 }
 
 void SceneGame_NewGame(SceneGame * const self)
 {
-    SceneManager_ClearTimers(self->sceneManager);
+    // Deleting the board cancels its own timers, other timers keep running.
     GameBoard_Delete(self->gameBoard);
 
-    self->gameBoard = GameBoard_New(self->renderer, &self->sceneGameRect, self->sceneManager);
+    self->gameBoard = GameBoard_New(self->graphics, &self->sceneGameRect, self->sceneManager);
 
     GameBoard_SetGameEvent(self->gameBoard, SceneGame_OnGameEvent, self);
     Header_SetCurrentPlayer(self->header, Player_1, None);
+
+    SceneGame_BuildDisplayList(self);
+}
+
+void SceneGame_BuildDisplayList(SceneGame * const self)
+{
+    // The board is recreated for every game, so the whole list is rebuilt with it.
+    DisplayList_Clear(self->displayList);
+
+    Rectangle_AddToDisplayList(self->background, self->displayList);
+
+    // The widgets don't overlap each other, so they share layers and their parts batch together.
+    DisplayList_SetLayer(self->displayList, 1);
+    GameBoard_AddToDisplayList(self->gameBoard, self->displayList);
+    Header_AddToDisplayList(self->header, self->displayList);
+    Footer_AddToDisplayList(self->footer, self->displayList);
+    Sidebar_AddToDisplayList(self->sidebar, self->displayList);
 }
 
 void SceneGame_OnPressed(Button * const button, void *user)
@@ -34,4 +34,4 @@ SceneGame *SceneGame_OnNew(SceneManager *sceneManager);
 void SceneGame_OnDelete(SceneGame * const self);
 void SceneGame_OnProcessEvent(SceneGame * const self, const SDL_Event *event);
 void SceneGame_OnUpdate(SceneGame * const self, double deltaTime);
-void SceneGame_OnDraw(SceneGame * const self);
+void SceneGame_OnDraw(SceneGame * const self, double alpha);
@@ -23,16 +23,20 @@ SOFTWARE.
 -------------------------------------------------------------------------------*/
 
 #include "Sidebar.h"
+#include "../base/Graphics.h"
+#include "../base/RenderBatch.h"
 #include "../base/Texture.h"
 #include "../base/Rectangle.h"
 #include "../base/Box.h"
+#include "../base/Layer.h"
+#include "../base/DisplayList.h"
 
 #include <malloc.h>
 #include <stdio.h>
 
 struct Sidebar
 {
-    SDL_Renderer *renderer;
+    Graphics *graphics;
     const SceneGameRect *sceneGameRect;
     int width;
     int player1_y;
@@ -54,24 +58,29 @@ struct Sidebar
     Texture *player2WinText;
     Texture *tiedText;
     Texture *tiedCountText;
+
+    Layer *layer;
 };
 
 void Sidebar_SetupSizes(Sidebar * const self);
 void Sidebar_CreateTextures(Sidebar * const self);
 void Sidebar_UpdateTextRect(Sidebar * const self, Texture *texture, int y);
 void Sidebar_UpdateText(Sidebar * const self, Texture *texture, int pos_y, int count);
+static void DrawLayer(void *userdata);
 
-Sidebar *Sidebar_New(SDL_Renderer *renderer, SceneGameRect *sceneGameRect)
+Sidebar *Sidebar_New(Graphics *graphics, SceneGameRect *sceneGameRect)
 {
     Sidebar * const self = malloc(sizeof (Sidebar));
 
-    self->renderer = renderer;
+    self->graphics = graphics;
     self->sceneGameRect = sceneGameRect;
     self->textColor = (SDL_Color) {120, 120, 120, 255};
 
     Sidebar_SetupSizes(self);
     Sidebar_CreateTextures(self);
 
+    self->layer = Layer_New(graphics, (SDL_FRect) {0.f, 0.f, sceneGameRect->sidebar_w, sceneGameRect->sidebar_h});
+
     return self;
 }
 
@@ -87,22 +96,42 @@ void Sidebar_Delete(Sidebar * const self)
     Texture_Delete(self->tiedText);
     Texture_Delete(self->tiedCountText);
 
+    Layer_Delete(self->layer);
+
     free(self);
 }
 
 void Sidebar_Draw(Sidebar * const self)
 {
-    Rectangle_Draw(self->background);
-    Rectangle_Draw(self->verticalLine);
-    Rectangle_Draw(self->horizontalLine1);
-    Rectangle_Draw(self->horizontalLine2);
-
-    Texture_Draw(self->player1Text);
-    Texture_Draw(self->player1WinText);
-    Texture_Draw(self->player2Text);
-    Texture_Draw(self->player2WinText);
-    Texture_Draw(self->tiedText);
-    Texture_Draw(self->tiedCountText);
+    if (Layer_Begin(self->layer))
+    {
+        RenderBatch *batch = Graphics_GetRenderBatch(self->graphics);
+        const int layer = RenderBatch_GetLayer(batch);
+
+        Rectangle_Draw(self->background);
+        Rectangle_Draw(self->verticalLine);
+        Rectangle_Draw(self->horizontalLine1);
+        Rectangle_Draw(self->horizontalLine2);
+
+        // The text covers the background, so it goes one layer up.
+        RenderBatch_SetLayer(batch, layer + 1);
+        Texture_Draw(self->player1Text);
+        Texture_Draw(self->player1WinText);
+        Texture_Draw(self->player2Text);
+        Texture_Draw(self->player2WinText);
+        Texture_Draw(self->tiedText);
+        Texture_Draw(self->tiedCountText);
+        RenderBatch_SetLayer(batch, layer);
+
+        Layer_End(self->layer);
+    }
+
+    Layer_Draw(self->layer);
+}
+
+void Sidebar_AddToDisplayList(Sidebar * const self, DisplayList *displayList)
+{
+    DisplayList_AddCallback(displayList, DrawLayer, self);
 }
 
 void Sidebar_SetPlayer1WinText(Sidebar * const self, int count)
@@ -137,10 +166,10 @@ void Sidebar_SetupSizes(Sidebar * const self)
     self->tied_y = third_block + title_margin;
     self->tiedCount_y = third_block + number_margin;
 
-    self->background = Rectangle_New(self->renderer, self->width, self->sceneGameRect->sidebar_h);
-    self->verticalLine = Rectangle_New(self->renderer, border_w, self->sceneGameRect->sidebar_h);
-    self->horizontalLine1 = Rectangle_New(self->renderer, self->width, border_w);
-    self->horizontalLine2 = Rectangle_New(self->renderer, self->width, border_w);
+    self->background = Rectangle_New(self->graphics, self->width, self->sceneGameRect->sidebar_h);
+    self->verticalLine = Rectangle_New(self->graphics, border_w, self->sceneGameRect->sidebar_h);
+    self->horizontalLine1 = Rectangle_New(self->graphics, self->width, border_w);
+    self->horizontalLine2 = Rectangle_New(self->graphics, self->width, border_w);
 
     Rectangle_SetColorRGBA(self->background, 240, 240, 240, 255);
     Rectangle_SetColorRGBA(self->verticalLine, 180, 180, 180, 255);
@@ -154,12 +183,12 @@ void Sidebar_SetupSizes(Sidebar * const self)
 
 void Sidebar_CreateTextures(Sidebar * const self)
 {
-    self->player1Text = Texture_New(self->renderer);
-    self->player1WinText = Texture_New(self->renderer);
-    self->player2Text = Texture_New(self->renderer);
-    self->player2WinText = Texture_New(self->renderer);
-    self->tiedText = Texture_New(self->renderer);
-    self->tiedCountText = Texture_New(self->renderer);
+    self->player1Text = Texture_New(self->graphics);
+    self->player1WinText = Texture_New(self->graphics);
+    self->player2Text = Texture_New(self->graphics);
+    self->player2WinText = Texture_New(self->graphics);
+    self->tiedText = Texture_New(self->graphics);
+    self->tiedCountText = Texture_New(self->graphics);
 
     Texture_SetText(self->player1Text, "Vitórias do jogador 1");
     Texture_SetText(self->player1WinText, "0");
@@ -216,4 +245,11 @@ void Sidebar_UpdateText(Sidebar * const self, Texture *texture, int pos_y, int c
     Texture_SetText(texture, text);
     Texture_MakeText(texture);
     Sidebar_UpdateTextRect(self, texture, pos_y);
+
+    Layer_Invalidate(self->layer);
+}
+
+void DrawLayer(void *userdata)
+{
+    Sidebar_Draw(userdata);
 }
@@ -29,10 +29,13 @@ SOFTWARE.
 #include <SDL2/SDL.h>
 
 typedef struct Sidebar Sidebar;
+typedef struct DisplayList DisplayList;
+typedef struct Graphics Graphics;
 
-Sidebar *Sidebar_New(SDL_Renderer *renderer, SceneGameRect *sceneGameRect);
+Sidebar *Sidebar_New(Graphics *graphics, SceneGameRect *sceneGameRect);
 void Sidebar_Delete(Sidebar * const self);
 void Sidebar_Draw(Sidebar * const self);
+void Sidebar_AddToDisplayList(Sidebar * const self, DisplayList *displayList);
 void Sidebar_SetPlayer1WinText(Sidebar * const self, int count);
 void Sidebar_SetPlayer2WinText(Sidebar * const self, int count);
 void Sidebar_SetTiedCountText(Sidebar * const self, int count);
@@ -9,11 +9,41 @@ set(SRC_FILES
     src/base/Graphics.h
     src/base/Texture.c
     src/base/Texture.h
+    src/base/TextureCache.c
+    src/base/TextureCache.h
+    src/base/TextureAtlas.c
+    src/base/TextureAtlas.h
+    src/base/RectPacker.c
+    src/base/RectPacker.h
+    src/base/ImageLoader.c
+    src/base/ImageLoader.h
+    src/base/ImageScaler.c
+    src/base/ImageScaler.h
+    src/base/Qoi.c
+    src/base/Qoi.h
+    src/base/AssetPack.c
+    src/base/AssetPack.h
+    src/base/AssetLoader.c
+    src/base/AssetLoader.h
+    src/base/DiskCache.c
+    src/base/DiskCache.h
+    src/base/FontCache.c
+    src/base/FontCache.h
+    src/base/GlyphAtlas.c
+    src/base/GlyphAtlas.h
+    src/base/RenderBatch.c
+    src/base/RenderBatch.h
+    src/base/Layer.c
+    src/base/Layer.h
+    src/base/DisplayList.c
+    src/base/DisplayList.h
     src/base/Button.c
     src/base/Button.h
     src/base/Rectangle.c
     src/base/Rectangle.h
     src/base/Box.h
+    src/base/Damage.c
+    src/base/Damage.h
     src/base/Box.c
     src/base/SceneManager.h
     src/base/SceneManager.c
@@ -23,6 +53,9 @@ set(SRC_FILES
     src/base/LinkedList.c
     src/base/private/Timer.h
     src/base/private/Timer.c
+    src/base/private/MappedFile.h
+    src/base/private/MappedFile.c
+    src/base/private/AssetPackFormat.h
     src/scene_game/SceneGameRect.h
     src/scene_game/SceneGame.c
     src/scene_game/SceneGame.h
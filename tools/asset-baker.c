@@ -0,0 +1,384 @@
+//-------------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Fábio Pichler
+/*-------------------------------------------------------------------------------
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+-------------------------------------------------------------------------------*/
+
+// Offline baker for assets.pack: decodes every image under the assets
+// directory into raw pixels and stores other files (fonts) verbatim.
+//
+// Usage: asset-baker <assets-dir> <output.pack> [argb8888|abgr8888]
+
+#define SDL_MAIN_HANDLED
+
+#include "../src/base/private/AssetPackFormat.h"
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <dirent.h>
+    #include <sys/stat.h>
+#endif
+
+typedef struct BakeEntry
+{
+    char *name;
+    Uint32 type;
+    Uint32 width;
+    Uint32 height;
+    Uint32 pitch;
+    void *data;
+    Uint32 size;
+    Uint32 offset;
+} BakeEntry;
+
+typedef struct BakeList
+{
+    BakeEntry *entries;
+    int count;
+    int capacity;
+} BakeList;
+
+static void CollectFiles(BakeList *list, const char *root, const char *relative);
+static void AddFile(BakeList *list, const char *root, const char *name);
+static bool IsImage(const char *name);
+static void *ReadWholeFile(const char *path, Uint32 *size);
+static bool WritePack(const BakeList *list, const char *fileName, Uint32 format);
+static void WriteU32(unsigned char *p, Uint32 value);
+static int CompareEntries(const void *a, const void *b);
+
+static Uint32 pixelFormat = SDL_PIXELFORMAT_ARGB8888;
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3)
+    {
+        printf("Usage: %s <assets-dir> <output.pack> [argb8888|abgr8888]\n", argv[0]);
+        return 1;
+    }
+
+    if (argc > 3)
+    {
+        if (SDL_strcasecmp(argv[3], "abgr8888") == 0)
+            pixelFormat = SDL_PIXELFORMAT_ABGR8888;
+        else if (SDL_strcasecmp(argv[3], "argb8888") != 0)
+        {
+            printf("Unknown pixel format: %s\n", argv[3]);
+            return 1;
+        }
+    }
+
+    const int imgFlags = IMG_INIT_PNG | IMG_INIT_JPG;
+
+    if (!(IMG_Init(imgFlags) & imgFlags))
+    {
+        printf("SDL_image could not initialize! SDL_image Error: %s\n", IMG_GetError());
+        return 1;
+    }
+
+    BakeList list = { NULL, 0, 0 };
+
+    CollectFiles(&list, argv[1], "");
+
+    // Sorted names keep the output byte-identical between runs.
+    qsort(list.entries, list.count, sizeof (BakeEntry), CompareEntries);
+
+    const bool ok = WritePack(&list, argv[2], pixelFormat);
+
+    if (ok)
+        printf("Baked %d assets into %s\n", list.count, argv[2]);
+
+    for (int i = 0; i < list.count; ++i)
+    {
+        free(list.entries[i].name);
+        free(list.entries[i].data);
+    }
+
+    free(list.entries);
+    IMG_Quit();
+
+    return ok ? 0 : 1;
+}
+
+void CollectFiles(BakeList *list, const char *root, const char *relative)
+{
+    char path[1024];
+
+    snprintf(path, sizeof (path), "%s/%s", root, relative);
+
+#ifdef _WIN32
+    char pattern[1024];
+    WIN32_FIND_DATAA data;
+
+    snprintf(pattern, sizeof (pattern), "%s*", path);
+
+    HANDLE find = FindFirstFileA(pattern, &data);
+
+    if (find == INVALID_HANDLE_VALUE)
+        return;
+
+    do
+    {
+        const char *fileName = data.cFileName;
+        const bool isDirectory = (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+#else
+    DIR *dir = opendir(path);
+
+    if (!dir)
+    {
+        printf("Could not open directory %s\n", path);
+        return;
+    }
+
+    for (struct dirent *item; (item = readdir(dir)) != NULL;)
+    {
+        const char *fileName = item->d_name;
+        char itemPath[1024];
+        struct stat info;
+
+        snprintf(itemPath, sizeof (itemPath), "%s%s", path, fileName);
+
+        if (stat(itemPath, &info) != 0)
+            continue;
+
+        const bool isDirectory = S_ISDIR(info.st_mode);
+#endif
+        char name[1024];
+
+        const char *extension = strrchr(fileName, '.');
+
+        // Skip hidden files and a previously baked pack in the same tree.
+        if (fileName[0] == '.' || (extension && SDL_strcasecmp(extension, ".pack") == 0))
+            continue;
+
+        snprintf(name, sizeof (name), "%s%s", relative, fileName);
+
+        if (isDirectory)
+        {
+            strncat(name, "/", sizeof (name) - strlen(name) - 1);
+            CollectFiles(list, root, name);
+        }
+        else
+        {
+            AddFile(list, root, name);
+        }
+#ifdef _WIN32
+    } while (FindNextFileA(find, &data));
+
+    FindClose(find);
+#else
+    }
+
+    closedir(dir);
+#endif
+}
+
+void AddFile(BakeList *list, const char *root, const char *name)
+{
+    char path[1024];
+    BakeEntry entry = { 0 };
+
+    snprintf(path, sizeof (path), "%s/%s", root, name);
+
+    if (IsImage(name))
+    {
+        SDL_Surface *loaded = IMG_Load(path);
+        SDL_Surface *surface = loaded ? SDL_ConvertSurfaceFormat(loaded, pixelFormat, 0) : NULL;
+
+        SDL_FreeSurface(loaded);
+
+        if (!surface)
+        {
+            printf("Failed to decode %s! SDL_image Error: %s\n", path, IMG_GetError());
+            return;
+        }
+
+        entry.type = AssetPack_Image;
+        entry.width = surface->w;
+        entry.height = surface->h;
+        entry.pitch = surface->w * 4;
+        entry.size = entry.pitch * entry.height;
+        entry.data = malloc(entry.size);
+
+        for (int y = 0; y < surface->h; ++y)
+            memcpy((char *)entry.data + y * entry.pitch, (char *)surface->pixels + y * surface->pitch, entry.pitch);
+
+        SDL_FreeSurface(surface);
+    }
+    else
+    {
+        entry.type = AssetPack_Raw;
+
+        if (!(entry.data = ReadWholeFile(path, &entry.size)))
+        {
+            printf("Failed to read %s\n", path);
+            return;
+        }
+    }
+
+    const size_t length = strlen(name) + 1;
+
+    entry.name = malloc(length);
+    memcpy(entry.name, name, length);
+
+    if (list->count == list->capacity)
+    {
+        list->capacity = list->capacity ? list->capacity * 2 : 64;
+        list->entries = realloc(list->entries, list->capacity * sizeof (BakeEntry));
+    }
+
+    list->entries[list->count++] = entry;
+}
+
+bool IsImage(const char *name)
+{
+    const char *extension = strrchr(name, '.');
+
+    return extension && (SDL_strcasecmp(extension, ".png") == 0
+                         || SDL_strcasecmp(extension, ".jpg") == 0
+                         || SDL_strcasecmp(extension, ".jpeg") == 0);
+}
+
+void *ReadWholeFile(const char *path, Uint32 *size)
+{
+    FILE *file = fopen(path, "rb");
+
+    if (!file)
+        return NULL;
+
+    fseek(file, 0, SEEK_END);
+    const long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    void *data = length > 0 ? malloc(length) : NULL;
+
+    if (data && fread(data, 1, length, file) != (size_t)length)
+    {
+        free(data);
+        data = NULL;
+    }
+
+    fclose(file);
+
+    *size = data ? (Uint32)length : 0;
+
+    return data;
+}
+
+bool WritePack(const BakeList *list, const char *fileName, Uint32 format)
+{
+    Uint32 slots = 1;
+
+    // Keep the table at most half full so probes stay short.
+    while (slots < (Uint32)list->count * 2)
+        slots *= 2;
+
+    const Uint32 entriesOffset = ASSET_PACK_HEADER_SIZE;
+    const Uint32 slotsOffset = entriesOffset + list->count * ASSET_PACK_ENTRY_SIZE;
+    const Uint32 namesOffset = slotsOffset + slots * 4;
+    Uint32 namesSize = 0;
+
+    for (int i = 0; i < list->count; ++i)
+        namesSize += (Uint32)strlen(list->entries[i].name);
+
+    Uint32 offset = namesOffset + namesSize;
+
+    for (int i = 0; i < list->count; ++i)
+    {
+        offset = (offset + ASSET_PACK_ALIGNMENT - 1) & ~(Uint32)(ASSET_PACK_ALIGNMENT - 1);
+        list->entries[i].offset = offset;
+        offset += list->entries[i].size;
+    }
+
+    unsigned char *pack = calloc(1, offset);
+    unsigned char *table = pack + slotsOffset;
+    Uint32 nameOffset = namesOffset;
+
+    memcpy(pack, ASSET_PACK_MAGIC, 4);
+    WriteU32(pack + 4, ASSET_PACK_VERSION);
+    WriteU32(pack + 8, format);
+    WriteU32(pack + 12, list->count);
+    WriteU32(pack + 16, slots);
+    WriteU32(pack + 20, entriesOffset);
+    WriteU32(pack + 24, slotsOffset);
+    WriteU32(pack + 28, namesOffset);
+
+    for (int i = 0; i < list->count; ++i)
+    {
+        const BakeEntry *entry = &list->entries[i];
+        unsigned char *record = pack + entriesOffset + i * ASSET_PACK_ENTRY_SIZE;
+        const Uint32 length = (Uint32)strlen(entry->name);
+
+        WriteU32(record, nameOffset - namesOffset);
+        WriteU32(record + 4, length);
+        WriteU32(record + 8, entry->type);
+        WriteU32(record + 12, entry->width);
+        WriteU32(record + 16, entry->height);
+        WriteU32(record + 20, entry->pitch);
+        WriteU32(record + 24, entry->offset);
+        WriteU32(record + 28, entry->size);
+
+        memcpy(pack + nameOffset, entry->name, length);
+        memcpy(pack + entry->offset, entry->data, entry->size);
+        nameOffset += length;
+
+        Uint32 slot = AssetPack_Hash(entry->name, length) & (slots - 1);
+
+        while (table[slot * 4] | table[slot * 4 + 1] | table[slot * 4 + 2] | table[slot * 4 + 3])
+            slot = (slot + 1) & (slots - 1);
+
+        WriteU32(table + slot * 4, i + 1);
+    }
+
+    FILE *file = fopen(fileName, "wb");
+    const bool ok = file && fwrite(pack, 1, offset, file) == offset;
+
+    if (file)
+        fclose(file);
+
+    if (!ok)
+        printf("Failed to write %s\n", fileName);
+
+    free(pack);
+
+    return ok;
+}
+
+void WriteU32(unsigned char *p, Uint32 value)
+{
+    p[0] = value & 0xff;
+    p[1] = (value >> 8) & 0xff;
+    p[2] = (value >> 16) & 0xff;
+    p[3] = (value >> 24) & 0xff;
+}
+
+int CompareEntries(const void *a, const void *b)
+{
+    return strcmp(((const BakeEntry *)a)->name, ((const BakeEntry *)b)->name);
+}
@@ -0,0 +1,295 @@
+//-------------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Fábio Pichler
+/*-------------------------------------------------------------------------------
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+-------------------------------------------------------------------------------*/
+
+// Compares PNG (SDL_image) and QOI (src/base/Qoi.c) decode times for a set
+// of images. Each PNG is re-encoded to QOI in memory; with --write the QOI
+// file is also saved next to it, ready to ship with PREFER_QOI.
+//
+// Usage: qoi-benchmark [--write] [--iterations N] <image.png>...
+
+#define SDL_MAIN_HANDLED
+
+#include "../src/base/Qoi.h"
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define QOI_HASH(p) (((p)[0] * 3 + (p)[1] * 5 + (p)[2] * 7 + (p)[3] * 11) % 64)
+
+static void *ReadWholeFile(const char *path, size_t *size);
+static unsigned char *EncodeQoi(SDL_Surface *surface, size_t *size);
+static void WriteU32BE(unsigned char *p, Uint32 value);
+static double Seconds(Uint64 start);
+
+int main(int argc, char *argv[])
+{
+    bool write = false;
+    int iterations = 50;
+    int first = 1;
+
+    for (; first < argc && argv[first][0] == '-'; ++first)
+    {
+        if (strcmp(argv[first], "--write") == 0)
+            write = true;
+        else if (strcmp(argv[first], "--iterations") == 0 && first + 1 < argc)
+            iterations = SDL_max(1, atoi(argv[++first]));
+    }
+
+    if (first >= argc)
+    {
+        printf("Usage: %s [--write] [--iterations N] <image.png>...\n", argv[0]);
+        return 1;
+    }
+
+    if (!(IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG))
+    {
+        printf("SDL_image could not initialize! SDL_image Error: %s\n", IMG_GetError());
+        return 1;
+    }
+
+    double pngTotal = 0.0, qoiTotal = 0.0;
+    size_t pngBytes = 0, qoiBytes = 0;
+    int count = 0;
+
+    printf("%-48s %10s %10s %10s %10s\n", "image", "png KiB", "png ms", "qoi KiB", "qoi ms");
+
+    for (int i = first; i < argc; ++i)
+    {
+        size_t pngSize;
+        void *png = ReadWholeFile(argv[i], &pngSize);
+        SDL_Surface *decoded = png ? IMG_Load_RW(SDL_RWFromConstMem(png, (int)pngSize), 1) : NULL;
+        SDL_Surface *rgba = decoded ? SDL_ConvertSurfaceFormat(decoded, SDL_PIXELFORMAT_RGBA32, 0) : NULL;
+
+        SDL_FreeSurface(decoded);
+
+        if (!rgba)
+        {
+            printf("Skipping %s: %s\n", argv[i], IMG_GetError());
+            free(png);
+            continue;
+        }
+
+        size_t qoiSize;
+        unsigned char *qoi = EncodeQoi(rgba, &qoiSize);
+
+        SDL_FreeSurface(rgba);
+
+        Uint64 start = SDL_GetPerformanceCounter();
+
+        for (int n = 0; n < iterations; ++n)
+            SDL_FreeSurface(IMG_Load_RW(SDL_RWFromConstMem(png, (int)pngSize), 1));
+
+        const double pngTime = Seconds(start) / iterations;
+
+        start = SDL_GetPerformanceCounter();
+
+        for (int n = 0; n < iterations; ++n)
+            SDL_FreeSurface(Qoi_Decode(qoi, qoiSize));
+
+        const double qoiTime = Seconds(start) / iterations;
+
+        printf("%-48s %10.1f %10.3f %10.1f %10.3f\n", argv[i],
+               pngSize / 1024.0, pngTime * 1000.0, qoiSize / 1024.0, qoiTime * 1000.0);
+
+        if (write)
+        {
+            char path[1024];
+            const char *extension = strrchr(argv[i], '.');
+            const int stem = extension ? (int)(extension - argv[i]) : (int)strlen(argv[i]);
+
+            snprintf(path, sizeof (path), "%.*s.qoi", stem, argv[i]);
+
+            FILE *file = fopen(path, "wb");
+
+            if (!file || fwrite(qoi, 1, qoiSize, file) != qoiSize)
+                printf("Failed to write %s\n", path);
+
+            if (file)
+                fclose(file);
+        }
+
+        pngTotal += pngTime;
+        qoiTotal += qoiTime;
+        pngBytes += pngSize;
+        qoiBytes += qoiSize;
+        count++;
+
+        free(qoi);
+        free(png);
+    }
+
+    if (count > 0)
+    {
+        printf("\n%d images: png %.1f KiB in %.3f ms (%.0f images/sec), qoi %.1f KiB in %.3f ms (%.0f images/sec), "
+               "%.1fx faster\n", count,
+               pngBytes / 1024.0, pngTotal * 1000.0, count / pngTotal,
+               qoiBytes / 1024.0, qoiTotal * 1000.0, count / qoiTotal,
+               qoiTotal > 0.0 ? pngTotal / qoiTotal : 0.0);
+    }
+
+    IMG_Quit();
+
+    return 0;
+}
+
+void *ReadWholeFile(const char *path, size_t *size)
+{
+    FILE *file = fopen(path, "rb");
+
+    if (!file)
+        return NULL;
+
+    fseek(file, 0, SEEK_END);
+    const long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    void *data = length > 0 ? malloc(length) : NULL;
+
+    if (data && fread(data, 1, length, file) != (size_t)length)
+    {
+        free(data);
+        data = NULL;
+    }
+
+    fclose(file);
+
+    *size = data ? (size_t)length : 0;
+
+    return data;
+}
+
+unsigned char *EncodeQoi(SDL_Surface *surface, size_t *size)
+{
+    const size_t pixels = (size_t)surface->w * surface->h;
+    unsigned char *out = malloc(14 + pixels * 5 + 8);
+    unsigned char index[64][4];
+    unsigned char prev[4] = {0, 0, 0, 255};
+    size_t p = 0;
+    int run = 0;
+
+    memset(index, 0, sizeof (index));
+
+    memcpy(out, "qoif", 4);
+    WriteU32BE(out + 4, surface->w);
+    WriteU32BE(out + 8, surface->h);
+    out[12] = 4;
+    out[13] = 0;
+    p = 14;
+
+    for (int y = 0; y < surface->h; ++y)
+    {
+        const unsigned char *row = (const unsigned char *)surface->pixels + (size_t)y * surface->pitch;
+
+        for (int x = 0; x < surface->w; ++x)
+        {
+            const unsigned char *px = row + x * 4;
+            const bool last = y == surface->h - 1 && x == surface->w - 1;
+
+            if (memcmp(px, prev, 4) == 0)
+            {
+                if (++run == 62 || last)
+                {
+                    out[p++] = 0xc0 | (run - 1);
+                    run = 0;
+                }
+
+                continue;
+            }
+
+            if (run > 0)
+            {
+                out[p++] = 0xc0 | (run - 1);
+                run = 0;
+            }
+
+            const int hash = QOI_HASH(px);
+
+            if (memcmp(index[hash], px, 4) == 0)
+            {
+                out[p++] = 0x00 | hash;
+            }
+            else
+            {
+                memcpy(index[hash], px, 4);
+
+                if (px[3] == prev[3])
+                {
+                    const signed char vr = px[0] - prev[0];
+                    const signed char vg = px[1] - prev[1];
+                    const signed char vb = px[2] - prev[2];
+                    const signed char vgr = vr - vg;
+                    const signed char vgb = vb - vg;
+
+                    if (vr > -3 && vr < 2 && vg > -3 && vg < 2 && vb > -3 && vb < 2)
+                    {
+                        out[p++] = 0x40 | (vr + 2) << 4 | (vg + 2) << 2 | (vb + 2);
+                    }
+                    else if (vgr > -9 && vgr < 8 && vg > -33 && vg < 32 && vgb > -9 && vgb < 8)
+                    {
+                        out[p++] = 0x80 | (vg + 32);
+                        out[p++] = (vgr + 8) << 4 | (vgb + 8);
+                    }
+                    else
+                    {
+                        out[p++] = 0xfe;
+                        out[p++] = px[0];
+                        out[p++] = px[1];
+                        out[p++] = px[2];
+                    }
+                }
+                else
+                {
+                    out[p++] = 0xff;
+                    memcpy(out + p, px, 4);
+                    p += 4;
+                }
+            }
+
+            memcpy(prev, px, 4);
+        }
+    }
+
+    memcpy(out + p, "\0\0\0\0\0\0\0\1", 8);
+    *size = p + 8;
+
+    return out;
+}
+
+void WriteU32BE(unsigned char *p, Uint32 value)
+{
+    p[0] = (value >> 24) & 0xff;
+    p[1] = (value >> 16) & 0xff;
+    p[2] = (value >> 8) & 0xff;
+    p[3] = value & 0xff;
+}
+
+double Seconds(Uint64 start)
+{
+    return (double)(SDL_GetPerformanceCounter() - start) / (double)SDL_GetPerformanceFrequency();
+}